@@ -26,7 +26,7 @@
 #define AM (1.0/IM)
 #define IQ 127773
 #define IR 2836
-#define NTAB 32
+#define NTAB RANBASE_NTAB
 #define NDIV (1+(IM-1)/NTAB)
 #define EPS 1.2e-7
 #define RNMX (1.0-EPS)
@@ -46,8 +46,8 @@ double ranbase::ran_short()
 {
     int j;
     long k;
-    static long iy=0;
-    static long iv[NTAB];
+    long &iy=iy_short;
+    long *iv=iv_short;
     double Temp;
     long idum;
 
@@ -97,7 +97,7 @@ double ranbase::ran_short()
 #define IQ2 52774
 #define IR1 12211
 #define IR2 3791
-#define NTAB 32
+#define NTAB RANBASE_NTAB
 #define NDIV (1+IMM1/NTAB)
 #define EPS 1.2e-7
 #define RNMX (1.0-EPS)
@@ -118,9 +118,9 @@ double ranbase::ran_long()
 {
     int j;
     long k;
-    static long idum2=123456789;
-    static long iy=0;
-    static long iv[NTAB];
+    long &idum2=idum2_long;
+    long &iy=iy_long;
+    long *iv=iv_long;
     double temp;
     long idum;
 
@@ -209,6 +209,28 @@ void ranbase::initialize_random_generators(int rc)
     rcall_internal[2]=0;
 }
 
+int ranbase::initialize_stream(int rc, long seed)
+///******************************************************************
+/// INITIALIZE_STREAM
+/// -----------------------------------------------------------------
+/// silent version of initialize_random_generators for parallel
+/// streams: the congruential generators start from the given seed
+/// instead of 1, such that objects with different seeds deliver
+/// different sequences. returns 1 on success and 0 for an unknown rc
+/// -----------------------------------------------------------------
+/// rc      - IN: integer which specifies which random number generator
+///               is called
+/// seed    - IN: seed of the stream (>=1)
+/// -----------------------------------------------------------------
+{
+    if(rc!=1 && rc!=2) return 0;
+    rchoice_internal=rc;
+    for(int i=0;i<3;i++) rcall_internal[i]=0;
+    idum_internal[0]=idum_internal[1]=-((seed>0) ? seed : 1);
+    iset_gauss=0;
+    return 1;
+}
+
 void ranbase::get_num_calls()
 ///******************************************************************
 /// GET_NUM_CALLS
@@ -260,8 +282,8 @@ double ranbase::ran_gauss()
 /// no input arguments
 /// -----------------------------------------------------------------
 {
-    static int iset=0;
-    static double gset;
+    int &iset=iset_gauss;
+    double &gset=gset_gauss;
     double fac,rsq,v1,v2;
 
     rcall_internal[2]++;
@@ -27,6 +27,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+//size of the shuffle tables of ran_short and ran_long
+#define RANBASE_NTAB 32
+
 class ranbase
         {
         private:
@@ -38,6 +41,16 @@ class ranbase
     long rcall_internal[3];
     int rchoice_internal=0;
 
+    //state of the generators, kept per object such that every thread can
+    //draw from its own stream
+    long iy_short=0;
+    long iv_short[RANBASE_NTAB];
+    long iy_long=0;
+    long idum2_long=123456789;
+    long iv_long[RANBASE_NTAB];
+    int iset_gauss=0;
+    double gset_gauss=0.0;
+
 
     double ran_short();
 
@@ -82,6 +95,21 @@ class ranbase
 /// -----------------------------------------------------------------
 /// rc      - IN: integer which specifies which random number generator
 ///               is called
+/// -----------------------------------------------------------------
+
+    int initialize_stream(int rc, long seed);
+
+///******************************************************************
+/// INITIALIZE_STREAM
+/// -----------------------------------------------------------------
+/// silent version of initialize_random_generators for parallel
+/// streams: the congruential generators start from the given seed
+/// instead of 1, such that objects with different seeds deliver
+/// different sequences. returns 1 on success and 0 for an unknown rc
+/// -----------------------------------------------------------------
+/// rc      - IN: integer which specifies which random number generator
+///               is called
+/// seed    - IN: seed of the stream (>=1)
 /// -----------------------------------------------------------------
 
     void get_num_calls();
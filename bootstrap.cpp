@@ -0,0 +1,175 @@
+//
+// Created by stefan on 11.05.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "bootstrap.h"
+#include "baserandom.h"
+#include "recstats.h"
+#include "metrics.h"
+#include "parallel.h"
+#include <math.h>
+#include <algorithm>
+
+int bootstrap::setup(const samplestore &store, int nstatic)
+///******************************************************************
+/// SETUP
+/// -----------------------------------------------------------------
+/// copies the samples 0..nstatic-1 of store as static segment.
+/// returns 1 on success and 0 if the segment is too short
+/// -----------------------------------------------------------------
+/// store   - IN: samples
+/// nstatic - IN: length of the static segment
+/// -----------------------------------------------------------------
+{
+    if(nstatic<2 || nstatic>(int) store.size()) return 0;
+    n=nstatic;
+    for(int j=0;j<3;j++)
+    {
+        x[j].resize(n);
+        store.copy_axis(j,0,n,x[j].data());
+        prefix[j].resize(n+1);
+        prefix[j][0]=0.0;
+        for(int i=0;i<n;i++) prefix[j][i+1]=prefix[j][i]+x[j][i];
+    }
+    return 1;
+}
+
+int bootstrap::block_length() const
+{
+    int l=(block>0) ? block : (int) lround(cbrt((double) n));
+
+    return max(1,min(l,n));
+}
+
+void bootstrap::replicate(int b, const int start[], int nb, int m)
+{
+    int l=block_length();
+
+    //mean of the segment: every block from the prefix sums, the last one cut
+    for(int j=0;j<3;j++)
+    {
+        const double *p=prefix[j].data();
+        double sum=0.0;
+        for(int k=0;k<nb;k++)
+        {
+            int len=min(l,n-k*l);
+            sum+=p[start[k]+len]-p[start[k]];
+        }
+        mean_rep[j][b]=sum/(double) n;
+    }
+    if(m<2) return;
+
+    //recursive estimate after m samples: the recursion over the blocks
+    recstat rs;
+    for(int j=0;j<3;j++)
+    {
+        const double *c=x[j].data();
+        double stat[4]={0.0,0.0,0.0,0.0};
+        int i=1;
+        for(int k=0;i<=m;k++)
+        {
+            for(int q=0;q<l && i<=m;q++,i++) rs.seq_update(stat,c[start[k]+q],i);
+        }
+        rec_rep[j][b]=stat[2];
+    }
+}
+
+void bootstrap::run(int m)
+///******************************************************************
+/// RUN
+/// -----------------------------------------------------------------
+/// draws the replicates of the mean of the segment and of the
+/// recursive estimate after m samples (skipped for m<2)
+/// -----------------------------------------------------------------
+/// m     - IN: samples of the recursive estimate
+/// -----------------------------------------------------------------
+{
+    int l=block_length(),nchunk,nt;
+    //blocks per replicate: enough for the segment and for m samples
+    int nb=max((n+l-1)/l,(m+l-1)/l);
+    uint64_t t0=metrics::now();
+
+    for(int j=0;j<3;j++)
+    {
+        mean_rep[j].assign(replicates,0.0);
+        rec_rep[j].assign((m>=2) ? replicates : 0,0.0);
+    }
+    nchunk=(replicates+BOOTSTRAP_CHUNK-1)/BOOTSTRAP_CHUNK;
+    nt=worker_count(threads,nchunk);
+
+    run_parallel(nt,[&](int r)
+    {
+        ranbase randy;
+        vector<int> start(nb);
+        for(int c=r;c<nchunk;c+=nt)
+        {
+            randy.initialize_stream(2,seed+c);
+            for(int b=c*BOOTSTRAP_CHUNK;b<min(replicates,(c+1)*BOOTSTRAP_CHUNK);b++)
+            {
+                //the block starts are drawn once for all components
+                for(int k=0;k<nb;k++) start[k]=min(n-l,(int) (randy.ran_long()*(n-l+1)));
+                replicate(b,start.data(),nb,m);
+            }
+        }
+    });
+    seconds=1.0e-9*(metrics::now()-t0);
+}
+
+void bootstrap::interval(const vector<double> &rep, double level, double &lo, double &hi)
+///******************************************************************
+/// INTERVAL
+/// -----------------------------------------------------------------
+/// percentile interval of the given level (e.g. 0.95) of the
+/// replicates rep, linearly interpolated between order statistics
+/// -----------------------------------------------------------------
+/// rep   - IN : replicates
+/// level - IN : confidence level
+/// lo    - OUT: lower limit
+/// hi    - OUT: upper limit
+/// -----------------------------------------------------------------
+{
+    vector<double> v(rep);
+    double q[2]={0.5*(1.0-level),0.5*(1.0+level)},r[2];
+
+    if(v.empty()) {lo=hi=0.0; return;}
+    sort(v.begin(),v.end());
+    for(int k=0;k<2;k++)
+    {
+        double pos=q[k]*(double) (v.size()-1);
+        size_t i=(size_t) pos;
+        double w=pos-(double) i;
+        r[k]=(i+1<v.size()) ? v[i]+w*(v[i+1]-v[i]) : v[i];
+    }
+    lo=r[0];
+    hi=r[1];
+}
+
+double bootstrap::coverage(const vector<double> &rep, double ref, double f)
+///******************************************************************
+/// COVERAGE
+/// -----------------------------------------------------------------
+/// fraction of the replicates rep within f*|ref| of ref: the
+/// bootstrap counterpart of recstat::seq_accept_probability
+/// -----------------------------------------------------------------
+/// rep   - IN: replicates
+/// ref   - IN: reference value
+/// f     - IN: fractional accuracy
+/// -----------------------------------------------------------------
+{
+    long hit=0;
+
+    if(rep.empty()) return 0.0;
+    for(double v : rep) if(fabs(v-ref)<=f*fabs(ref)) hit++;
+    return (double) hit/(double) rep.size();
+}
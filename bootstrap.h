@@ -0,0 +1,118 @@
+//
+// Created by stefan on 11.05.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_BOOTSTRAP_H
+#define PUBLICATION_RECURSIVE_MEAN_BOOTSTRAP_H
+
+#include "samplestore.h"
+#include <vector>
+using namespace std;
+
+#define BOOTSTRAP_CHUNK 64            //replicates drawn from one random number stream
+
+//*******************************************************************
+// distribution-free confidence intervals by the moving block
+// bootstrap: replicates of the static segment are assembled from
+// blocks of consecutive samples (which keeps the autocorrelation of
+// the sensor within a block) starting at uniformly drawn positions.
+// Two statistics are resampled for the three components: the mean of
+// a replicate of the full segment (the static calibration gyro_off)
+// and the recursive estimate (stat[2] of recstat::seq_update) after m
+// samples, i.e. the offset the recursion reports when it converges
+// after m samples. The block starts of a replicate are drawn once into
+// a small buffer and used for all components, the mean is summed from
+// prefix sums in O(1) per block and the recursion walks contiguous
+// columns. The replicates are split into chunks of BOOTSTRAP_CHUNK,
+// each with its own ranbase stream seeded by the chunk index, and the
+// chunks are spread over the threads, such that the result does not
+// depend on the number of threads.
+//*******************************************************************
+
+class bootstrap {
+
+private:
+
+    vector<double> x[3];      //static segment, one column per component
+    vector<double> prefix[3]; //prefix sums of the columns
+    int n=0;                  //length of the static segment
+
+    void replicate(int b, const int start[], int nb, int m);
+
+public:
+
+    int replicates=2000;      //number of bootstrap replicates
+    int block=0;              //block length (0: cube root of the segment length)
+    int threads=0;            //worker threads (0: all cores)
+    long seed=1;              //seed of the first chunk
+    vector<double> mean_rep[3];   //replicates of the mean of the segment
+    vector<double> rec_rep[3];    //replicates of the recursive estimate
+    double seconds=0.0;       //wall clock time of the last run
+
+    ///******************************************************************
+    /// SETUP
+    /// -----------------------------------------------------------------
+    /// copies the samples 0..nstatic-1 of store as static segment.
+    /// returns 1 on success and 0 if the segment is too short
+    /// -----------------------------------------------------------------
+    /// store   - IN: samples
+    /// nstatic - IN: length of the static segment
+    /// -----------------------------------------------------------------
+
+    int setup(const samplestore &store, int nstatic);
+
+    ///******************************************************************
+    /// RUN
+    /// -----------------------------------------------------------------
+    /// draws the replicates of the mean of the segment and of the
+    /// recursive estimate after m samples (skipped for m<2)
+    /// -----------------------------------------------------------------
+    /// m     - IN: samples of the recursive estimate
+    /// -----------------------------------------------------------------
+
+    void run(int m);
+
+    ///******************************************************************
+    /// INTERVAL
+    /// -----------------------------------------------------------------
+    /// percentile interval of the given level (e.g. 0.95) of the
+    /// replicates rep, linearly interpolated between order statistics
+    /// -----------------------------------------------------------------
+    /// rep   - IN : replicates
+    /// level - IN : confidence level
+    /// lo    - OUT: lower limit
+    /// hi    - OUT: upper limit
+    /// -----------------------------------------------------------------
+
+    static void interval(const vector<double> &rep, double level, double &lo, double &hi);
+
+    ///******************************************************************
+    /// COVERAGE
+    /// -----------------------------------------------------------------
+    /// fraction of the replicates rep within f*|ref| of ref: the
+    /// bootstrap counterpart of recstat::seq_accept_probability
+    /// -----------------------------------------------------------------
+    /// rep   - IN: replicates
+    /// ref   - IN: reference value
+    /// f     - IN: fractional accuracy
+    /// -----------------------------------------------------------------
+
+    static double coverage(const vector<double> &rep, double ref, double f);
+
+    int block_length() const;
+    int size() const {return n;}
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_BOOTSTRAP_H
@@ -0,0 +1,170 @@
+//
+// Created by stefan on 27.04.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "calibrator.h"
+#include <math.h>
+#include <limits.h>
+
+calibrator::calibrator()
+{
+    recgyro_default_config(&cfg);
+    reset();
+}
+
+int calibrator::configure(const recgyro_config &c)
+///******************************************************************
+/// CONFIGURE
+/// -----------------------------------------------------------------
+/// checks and takes over the configuration and resets the
+/// calibration. returns 0 or RECGYRO_ERR_ARG
+/// -----------------------------------------------------------------
+/// c     - IN: configuration
+/// -----------------------------------------------------------------
+{
+    //the robust gate keeps its counters where seq_update_long keeps the compensation
+    if(!(c.prop>0.0 && c.prop<1.0) || !(c.fractional>0.0) || c.min_runs<1 || !(c.robust_c>=0.0) ||
+       (c.long_horizon!=0 && c.robust_c>0.0))
+    {
+        return RECGYRO_ERR_ARG;
+    }
+    cfg=c;
+    reset();
+    return 0;
+}
+
+void calibrator::set_callbacks(recgyro_axis_callback axis, recgyro_done_callback done, void *u)
+///******************************************************************
+/// SET_CALLBACKS
+/// -----------------------------------------------------------------
+/// installs the callbacks (each may be null) and their user pointer
+/// -----------------------------------------------------------------
+/// axis  - IN: called once per component on its convergence
+/// done  - IN: called once when all components have converged
+/// u     - IN: passed through to the callbacks
+/// -----------------------------------------------------------------
+{
+    on_axis=axis;
+    on_done=done;
+    user=u;
+}
+
+void calibrator::reset()
+///******************************************************************
+/// RESET
+/// -----------------------------------------------------------------
+/// restarts the calibration
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+{
+    for(int j=0;j<3;j++)
+    {
+        for(int k=0;k<RECSTAT_ROBUST_SIZE;k++) stat[j][k]=0.0;
+        pval[j]=0.0;
+        iconv[j]=0;
+    }
+    n=0;
+    status=RECGYRO_RUNNING;
+}
+
+int calibrator::push(const double x[])
+///******************************************************************
+/// PUSH
+/// -----------------------------------------------------------------
+/// feeds the sample x[0..2] into the recursion. returns
+/// RECGYRO_RUNNING, RECGYRO_CONVERGED (the sample is ignored once
+/// converged), RECGYRO_ERR_SAMPLE if a component is not finite or
+/// RECGYRO_ERR_OVERFLOW once INT_MAX samples are in the recursion
+/// without long_horizon (the sample is ignored)
+/// -----------------------------------------------------------------
+/// x     - IN: gyroscopic sample
+/// -----------------------------------------------------------------
+{
+    double min=1.1;
+
+    if(status==RECGYRO_CONVERGED) return status;
+    if(!isfinite(x[0]) || !isfinite(x[1]) || !isfinite(x[2])) return RECGYRO_ERR_SAMPLE;
+    //seq_update takes the count as int, seq_update_robust its counts in doubles as int
+    if(!cfg.long_horizon && n>=INT_MAX) return RECGYRO_ERR_OVERFLOW;
+
+    n++;
+    for(int j=0;j<3;j++)
+    {
+        if(cfg.long_horizon) rs.seq_update_long(stat[j],x[j],n);
+        else if(cfg.robust_c>0.0) rs.seq_update_robust(stat[j],x[j],cfg.robust_c);
+        else rs.seq_update(stat[j],x[j],(int) n);
+        //no probability before the warm-up of the gate is complete
+        if(cfg.robust_c>0.0 && !recstat::robust_seeded(stat[j])) pval[j]=0.0;
+        else pval[j]=rs.seq_accept_probability(stat[j],cfg.fractional);
+        if(min>=pval[j]) min=pval[j];
+    }
+
+    //convergence test of main.cpp (its run counter is n+1 here)
+    if(n+1<cfg.min_runs) return status;
+    for(int j=0;j<3;j++)
+    {
+        if(pval[j]>=cfg.prop && iconv[j]==0)
+        {
+            iconv[j]=1;
+            if(on_axis!=nullptr) on_axis(user,j,n,stat[j][2],pval[j]);
+        }
+    }
+    if(min>=cfg.prop)
+    {
+        status=RECGYRO_CONVERGED;
+        if(on_done!=nullptr)
+        {
+            double off[3]={stat[0][2],stat[1][2],stat[2][2]};
+            on_done(user,n,off);
+        }
+    }
+    return status;
+}
+
+int calibrator::push_block(const double xyz[], int m)
+///******************************************************************
+/// PUSH_BLOCK
+/// -----------------------------------------------------------------
+/// feeds the samples xyz[3*k..3*k+2], k<m, until convergence or the
+/// first sample which is not finite. returns as push
+/// -----------------------------------------------------------------
+/// xyz   - IN: samples as x,y,z triples
+/// m     - IN: number of samples
+/// -----------------------------------------------------------------
+{
+    int res=status;
+
+    for(int k=0;k<m && res==RECGYRO_RUNNING;k++) res=push(xyz+3*k);
+    return res;
+}
+
+int calibrator::offsets(double offset[], double prob[]) const
+///******************************************************************
+/// OFFSETS
+/// -----------------------------------------------------------------
+/// returns the current offsets (mean of means) and acceptance
+/// probabilities (prob may be null) together with the status
+/// -----------------------------------------------------------------
+/// offset- OUT: offsets of the three components
+/// prob  - OUT: acceptance probabilities of the three components
+/// -----------------------------------------------------------------
+{
+    for(int j=0;j<3;j++)
+    {
+        offset[j]=stat[j][2];
+        if(prob!=nullptr) prob[j]=pval[j];
+    }
+    return status;
+}
@@ -0,0 +1,127 @@
+//
+// Created by stefan on 27.04.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_CALIBRATOR_H
+#define PUBLICATION_RECURSIVE_MEAN_CALIBRATOR_H
+
+#include "recgyro.h"
+#include "recstats.h"
+
+//*******************************************************************
+// push-style calibration of the three components of a gyroscope (C++
+// interface of librecgyro, the C interface in recgyro.h wraps it).
+// Every pushed sample enters the recursion (recstat::seq_update, with
+// a gate seq_update_robust and for long horizons seq_update_long) and
+// the convergence test of main.cpp; the callbacks are invoked when a
+// component resp. all components have converged. All state has a fixed
+// size, so pushing never allocates. Codes are those of recgyro.h.
+//*******************************************************************
+
+class calibrator {
+
+private:
+
+    recstat rs;
+    double stat[3][RECSTAT_ROBUST_SIZE];
+    double pval[3];           //acceptance probabilities of the last sample
+    int iconv[3];             //1 once the component has converged
+    int64_t n=0;              //samples in the recursion
+    int status=RECGYRO_RUNNING;
+    recgyro_axis_callback on_axis=nullptr;
+    recgyro_done_callback on_done=nullptr;
+    void *user=nullptr;
+
+public:
+
+    recgyro_config cfg;
+
+    calibrator();
+
+    ///******************************************************************
+    /// CONFIGURE
+    /// -----------------------------------------------------------------
+    /// checks and takes over the configuration and resets the
+    /// calibration. returns 0 or RECGYRO_ERR_ARG
+    /// -----------------------------------------------------------------
+    /// c     - IN: configuration
+    /// -----------------------------------------------------------------
+
+    int configure(const recgyro_config &c);
+
+    ///******************************************************************
+    /// SET_CALLBACKS
+    /// -----------------------------------------------------------------
+    /// installs the callbacks (each may be null) and their user pointer
+    /// -----------------------------------------------------------------
+    /// axis  - IN: called once per component on its convergence
+    /// done  - IN: called once when all components have converged
+    /// u     - IN: passed through to the callbacks
+    /// -----------------------------------------------------------------
+
+    void set_callbacks(recgyro_axis_callback axis, recgyro_done_callback done, void *u);
+
+    ///******************************************************************
+    /// RESET
+    /// -----------------------------------------------------------------
+    /// restarts the calibration
+    /// -----------------------------------------------------------------
+    /// no input arguments
+    /// -----------------------------------------------------------------
+
+    void reset();
+
+    ///******************************************************************
+    /// PUSH
+    /// -----------------------------------------------------------------
+    /// feeds the sample x[0..2] into the recursion. returns
+    /// RECGYRO_RUNNING, RECGYRO_CONVERGED (the sample is ignored once
+    /// converged), RECGYRO_ERR_SAMPLE if a component is not finite or
+    /// RECGYRO_ERR_OVERFLOW once INT_MAX samples are in the recursion
+    /// without long_horizon (the sample is ignored)
+    /// -----------------------------------------------------------------
+    /// x     - IN: gyroscopic sample
+    /// -----------------------------------------------------------------
+
+    int push(const double x[]);
+
+    ///******************************************************************
+    /// PUSH_BLOCK
+    /// -----------------------------------------------------------------
+    /// feeds the samples xyz[3*k..3*k+2], k<m, until convergence or the
+    /// first sample which is not finite. returns as push
+    /// -----------------------------------------------------------------
+    /// xyz   - IN: samples as x,y,z triples
+    /// m     - IN: number of samples
+    /// -----------------------------------------------------------------
+
+    int push_block(const double xyz[], int m);
+
+    ///******************************************************************
+    /// OFFSETS
+    /// -----------------------------------------------------------------
+    /// returns the current offsets (mean of means) and acceptance
+    /// probabilities (prob may be null) together with the status
+    /// -----------------------------------------------------------------
+    /// offset- OUT: offsets of the three components
+    /// prob  - OUT: acceptance probabilities of the three components
+    /// -----------------------------------------------------------------
+
+    int offsets(double offset[], double prob[]) const;
+
+    int64_t samples() const {return n;}
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_CALIBRATOR_H
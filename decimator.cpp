@@ -0,0 +1,160 @@
+//
+// Created by stefan on 02.03.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "decimator.h"
+#include <math.h>
+
+//harmonic number H_n, exact for small n and asymptotic expansion otherwise
+static double harmonic(int64_t n)
+{
+    double h=0.0,nd;
+
+    if(n<64)
+    {
+        for(int j=(int) n;j>=1;j--) h+=1.0/(double) j;
+        return h;
+    }
+    nd=(double) n;
+    return log(nd)+0.57721566490153286+0.5/nd-1.0/(12.0*nd*nd)+1.0/(120.0*nd*nd*nd*nd);
+}
+
+//expected variance of the running means of n samples of unit variance
+static double varmean_expect(int64_t n)
+{
+    double nd=(double) n;
+
+    if(n<=1) return 0.0;
+    return (harmonic(n)*(1.0+1.0/nd)-2.0)/(nd-1.0);
+}
+
+int decimator::push(const expdata::dynamic &s, expdata::dynamic &out)
+///******************************************************************
+/// PUSH
+/// -----------------------------------------------------------------
+/// streaming version: integrates the sample s and returns 1 if a
+/// block of factor samples is complete, its average is then given
+/// in out. returns 0 otherwise
+/// -----------------------------------------------------------------
+/// s     - IN : raw sample
+/// out   - OUT: decimated sample (if 1 is returned)
+/// -----------------------------------------------------------------
+{
+    double inv;
+
+    acc[0]+=s.t;
+    acc[1]+=s.x;
+    acc[2]+=s.y;
+    acc[3]+=s.z;
+    if(++count<factor) return 0;
+
+    //dump
+    inv=1.0/(double) factor;
+    out.t=acc[0]*inv;
+    out.x=acc[1]*inv;
+    out.y=acc[2]*inv;
+    out.z=acc[3]*inv;
+    for(int j=0;j<4;j++) acc[j]=0.0;
+    count=0;
+    return 1;
+}
+
+//sum of p[0..n-1] with four partial sums (independent lanes of a vector)
+static double block_sum(const double p[], int n)
+{
+    double a[4]={0.0,0.0,0.0,0.0},sum;
+    int k=0;
+
+    for(;k+4<=n;k+=4)
+    {
+        for(int l=0;l<4;l++) a[l]+=p[k+l];
+    }
+    sum=(a[0]+a[1])+(a[2]+a[3]);
+    for(;k<n;k++) sum+=p[k];
+    return sum;
+}
+
+int decimator::push_block(const samplestore &in, size_t i0, expdata::dynamic &out)
+///******************************************************************
+/// PUSH_BLOCK
+/// -----------------------------------------------------------------
+/// block version of push for stored samples: integrates the factor
+/// samples of in from i0 on and returns 1 with their average in out,
+/// or 0 if fewer than factor samples are left. the columns are
+/// summed one after the other over contiguous memory with four
+/// partial sums, which the compiler maps onto vector instructions
+/// (the averages equal those of push up to rounding). a block
+/// started by push has to be completed by push
+/// -----------------------------------------------------------------
+/// in    - IN : raw samples
+/// i0    - IN : first sample of the block
+/// out   - OUT: decimated sample (if 1 is returned)
+/// -----------------------------------------------------------------
+{
+    double inv=1.0/(double) factor,col[3];
+
+    if(i0+(size_t) factor>in.size()) return 0;
+    if(buf.size()<(size_t) factor) buf.resize(factor);
+    //each component is converted and summed over contiguous memory
+    for(int j=0;j<3;j++)
+    {
+        in.copy_axis(j,i0,factor,buf.data());
+        col[j]=block_sum(buf.data(),factor)*inv;
+    }
+    out.t=block_sum(in.times()+i0,factor)*inv;
+    out.x=col[0];
+    out.y=col[1];
+    out.z=col[2];
+    return 1;
+}
+
+double decimator::varmean_scale(int64_t k, int d)
+///******************************************************************
+/// VARMEAN_SCALE
+/// -----------------------------------------------------------------
+/// for independent samples of variance s^2 the expected variance of
+/// the running means m_1..m_n (stat[3] of seq_update) is
+///     s^2/(n-1)*(H_n*(1+1/n)-2)    (H_n: harmonic number)
+/// the decimated stream has variance s^2/d and sees only every d-th
+/// running mean. returns the ratio of the expectation for n=k*d raw
+/// samples to the one for k decimated samples, i.e. the factor
+/// which maps stat[3] of the decimated stream onto the raw stream
+/// -----------------------------------------------------------------
+/// k     - IN : number of decimated samples
+/// d     - IN : decimation factor
+/// -----------------------------------------------------------------
+{
+    double ed;
+
+    if(d<=1) return 1.0;
+    ed=varmean_expect(k)/(double) d;
+    if(ed<=0.0) return (double) d;
+    return varmean_expect(k*(int64_t) d)/ed;
+}
+
+double decimator::seq_accept_probability(double stat[], double f, int64_t k, int d)
+///******************************************************************
+/// SEQ_ACCEPT_PROBABILITY
+/// -----------------------------------------------------------------
+/// acceptance probability of recstat::seq_accept_probability for
+/// statistics computed on the decimated stream
+/// -----------------------------------------------------------------
+/// stat  - IN : storage array of recstat::seq_update
+/// f     - IN : required fractional accuracy
+/// k     - IN : number of decimated samples
+/// d     - IN : decimation factor
+/// -----------------------------------------------------------------
+{
+    return (erf((f*stat[2])/(sqrt(2*varmean_scale(k,d)*stat[3]))));
+}
@@ -0,0 +1,110 @@
+//
+// Created by stefan on 02.03.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_DECIMATOR_H
+#define PUBLICATION_RECURSIVE_MEAN_DECIMATOR_H
+
+#include "expdata.h"
+#include "samplestore.h"
+#include <stdint.h>
+
+//*******************************************************************
+// decimating pre-stage for high-rate gyroscopes: a first order CIC
+// filter (integrate and dump) replaces each block of D samples by its
+// average. The running mean of the decimated stream after k outputs
+// is exactly the running mean of the raw stream after k*D samples.
+// Higher order CIC or FIR stages are not used on purpose: their
+// outputs are correlated, which would invalidate the variance of the
+// mean. The statistics of the decimated stream are corrected by
+// varmean_scale such that seq_accept_probability stays valid.
+//*******************************************************************
+
+class decimator {
+
+private:
+
+    double acc[4]={0.0,0.0,0.0,0.0};  //integrators for t,x,y,z
+    int count=0;                      //samples in the current block
+    vector<double> buf;               //one block of a component (push_block)
+
+public:
+
+    int factor=1;                     //decimation factor D
+
+    ///******************************************************************
+    /// PUSH
+    /// -----------------------------------------------------------------
+    /// streaming version: integrates the sample s and returns 1 if a
+    /// block of factor samples is complete, its average is then given
+    /// in out. returns 0 otherwise
+    /// -----------------------------------------------------------------
+    /// s     - IN : raw sample
+    /// out   - OUT: decimated sample (if 1 is returned)
+    /// -----------------------------------------------------------------
+
+    int push(const expdata::dynamic &s, expdata::dynamic &out);
+
+    ///******************************************************************
+    /// PUSH_BLOCK
+    /// -----------------------------------------------------------------
+    /// block version of push for stored samples: integrates the factor
+    /// samples of in from i0 on and returns 1 with their average in out,
+    /// or 0 if fewer than factor samples are left. the columns are
+    /// summed one after the other over contiguous memory with four
+    /// partial sums, which the compiler maps onto vector instructions
+    /// (the averages equal those of push up to rounding). a block
+    /// started by push has to be completed by push
+    /// -----------------------------------------------------------------
+    /// in    - IN : raw samples
+    /// i0    - IN : first sample of the block
+    /// out   - OUT: decimated sample (if 1 is returned)
+    /// -----------------------------------------------------------------
+
+    int push_block(const samplestore &in, size_t i0, expdata::dynamic &out);
+
+    ///******************************************************************
+    /// VARMEAN_SCALE
+    /// -----------------------------------------------------------------
+    /// for independent samples of variance s^2 the expected variance of
+    /// the running means m_1..m_n (stat[3] of seq_update) is
+    ///     s^2/(n-1)*(H_n*(1+1/n)-2)    (H_n: harmonic number)
+    /// the decimated stream has variance s^2/d and sees only every d-th
+    /// running mean. returns the ratio of the expectation for n=k*d raw
+    /// samples to the one for k decimated samples, i.e. the factor
+    /// which maps stat[3] of the decimated stream onto the raw stream
+    /// -----------------------------------------------------------------
+    /// k     - IN : number of decimated samples
+    /// d     - IN : decimation factor
+    /// -----------------------------------------------------------------
+
+    static double varmean_scale(int64_t k, int d);
+
+    ///******************************************************************
+    /// SEQ_ACCEPT_PROBABILITY
+    /// -----------------------------------------------------------------
+    /// acceptance probability of recstat::seq_accept_probability for
+    /// statistics computed on the decimated stream
+    /// -----------------------------------------------------------------
+    /// stat  - IN : storage array of recstat::seq_update
+    /// f     - IN : required fractional accuracy
+    /// k     - IN : number of decimated samples
+    /// d     - IN : decimation factor
+    /// -----------------------------------------------------------------
+
+    static double seq_accept_probability(double stat[], double f, int64_t k, int d);
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_DECIMATOR_H
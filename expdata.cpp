@@ -19,109 +19,424 @@
 #include "expdata.h"
 #include "math.h"
 #include "recstats.h"
+#include "metrics.h"
+#include "rgcodec.h"
+#include "timeindex.h"
+#include "parallel.h"
+#include <thread>
+#include <string.h>
 
-void expdata::read_data()
+//samples per block of the parallel reduction in static_calibration
+#define EXPDATA_REDUCE_BLOCK 65536
+
+//calls line(p,eol) for every line of the file whose first byte lies in
+//[begin,end). the line is terminated behind eol. returns 0 if the file
+//could not be opened
+template <class F>
+static int for_lines(const char *fname, long begin, long end, F line)
+{
+    const size_t block=1<<20;
+    vector<char> buf(block+1);
+    size_t have=0,got,n,used;
+    long pos;
+    bool eof,skip;
+    FILE *fp;
+
+    fp=fopen(fname,"rb");
+    if(fp==NULL) return 0;
+    //start one byte early: the (partial) line ending there belongs to the previous chunk
+    pos=(begin>0) ? begin-1 : 0;
+    skip=(begin>0);
+    fseek(fp,pos,SEEK_SET);
+    for(;;)
+    {
+        if(buf.size()<have+block+1) buf.resize(have+block+1);
+        got=fread(&buf[have],1,block,fp);
+        eof=(got<block);
+        n=have+got;
+        buf[n]='\0';
+        const char *p=buf.data(),*stop=p+n,*eol;
+        while(p<stop)
+        {
+            eol=(const char *) memchr(p,'\n',stop-p);
+            if(eol==NULL)
+            {
+                if(!eof) break;
+                eol=stop;
+            }
+            if(skip) skip=false;
+            else
+            {
+                if(pos+(p-buf.data())>=end) {fclose(fp); return 1;}
+                line(p,eol);
+            }
+            p=eol+1;
+        }
+        if(eof) break;
+        //carry the incomplete last line over
+        used=(size_t) (p-buf.data());
+        memmove(buf.data(),p,n-used);
+        have=n-used;
+        pos+=(long) used;
+    }
+    fclose(fp);
+    return 1;
+}
+
+//parallel mean of the components of store[0..n-1]: the incremental means
+//of fixed blocks are computed in parallel and merged in order
+static void parallel_mean(const samplestore &store, int n, int nthreads, double ma[])
+{
+    int nb=(n+EXPDATA_REDUCE_BLOCK-1)/EXPDATA_REDUCE_BLOCK;
+    vector<double> part(3*(size_t) nb);
+    int nt=worker_count(nthreads,nb);
+    double w;
+
+    run_parallel(nt,[&](int r)
+    {
+        for(int b=r;b<nb;b+=nt)
+        {
+            double *m=&part[3*(size_t) b];
+            int i0=b*EXPDATA_REDUCE_BLOCK,i1=min(n,i0+EXPDATA_REDUCE_BLOCK);
+            for(int j=0;j<3;j++)
+            {
+                for(int i=i0;i<i1;i++) recstat::mean(m[j],store.get(j,i),i-i0+1);
+            }
+        }
+    });
+    //merge of the block means weighted by the number of samples
+    for(int j=0;j<3;j++) ma[j]=part[j];
+    for(int b=1;b<nb;b++)
+    {
+        int i0=b*EXPDATA_REDUCE_BLOCK,nbk=min(n,i0+EXPDATA_REDUCE_BLOCK)-i0;
+        w=(double) nbk/(double) (i0+nbk);
+        for(int j=0;j<3;j++) ma[j]+=(part[3*(size_t) b+j]-ma[j])*w;
+    }
+}
+
+const char *expdata::acc_name=nullptr;
+const char *expdata::gyro_name=nullptr;
+int expdata::input_format=EXPDATA_INPUT_AUTO;
+
+int expdata::read_data(bool verbose)
 ///******************************************************************
 /// READ_DATA
 /// -----------------------------------------------------------------
 /// loads data from the files that are given by name in the file
-/// "dnames" this data is then stored in the global arrays acc_store
-/// and gyro_store. Additionally a global time-array is used.
+/// "dnames" this data is then stored in the columnar store
+/// gyro_store (type of the components as set in gyro_store).
+/// returns 1 on success and 0 if the file could not be read (errors
+/// are always reported, the name of the file only if verbose)
 /// -----------------------------------------------------------------
-/// no (direct) input arguments
+/// verbose - IN: report the file which is loaded
 /// -----------------------------------------------------------------
 {
     char fname[150],fname2[150];
-    string line;
-    dynamic gyro_in;
+    metrics_timer timer(MET_READ_DATA);
 
     //read the name of the files from which the gyroscopic
     // (and potentially) the acceleration data is extracted
-    ifstream data2;
-    data2.open("dnames");
-    data2>>fname;
-    data2>>fname2;
-    data2.close();
-
-    //source files for acceleration and gyro-values
-    ifstream data3,data4;
-    //we only need the gyroscopic data
-    data4.open(fname2);
-
-    //load the content of the gyro-file into memory
-    data_size=0;
-    if(data4.is_open())
-    {
-        printf("loading gyro-data from file: %s\n",fname2);
-        while(getline(data4,line))
-        {
-            istringstream in(line);
-            data_size++;
-            in >> gyro_in.t;
-            in >> gyro_in.x;
-            in >> gyro_in.y;
-            in >> gyro_in.z;
-            gyro_store.push_back(gyro_in);
-        }
-    }
-    else
+    read_names(fname,fname2);
+
+    //we only need the gyroscopic data: load the content of the gyro-file into memory
+    data_size=read_file(fname2,gyro_store,threads,input_format);
+    if(data_size<0)
     {
-        printf("could not find file: %s\n",fname2);
-        exit(0);
+        printf("%s: %s\n",read_error(data_size),fname2);
+        data_size=0;
+        return 0;
     }
-
-    //store the size of the collected data and fill data into the storage array
-    global_times=new double[data_size];
-    for(int i=0;i<data_size;i++) global_times[i]=gyro_store[i].t;
-
-    //close the input file stream
-    data4.close();
+    if(verbose) printf("loading gyro-data from file: %s\n",fname2);
+    metrics::add(MET_SAMPLES_READ,data_size);
+    return 1;
 }
 
 void expdata::set_static_int()
 ///******************************************************************
 /// SET_STATIC_INT
 /// -----------------------------------------------------------------
-/// compute the length of the initial static period by bisection on
-/// the table of input-times
+/// compute the length of the initial static period by a search on
+/// the time column of gyro_store (class timeindex)
 /// -----------------------------------------------------------------
 /// no input argument
 /// -----------------------------------------------------------------
 {
-    expdata::static_int=mathb::locate(static_time,global_times,data_size);
+    timeindex index;
+    metrics_timer timer(MET_SET_STATIC_INT);
+
+    index.build(gyro_store.times(),data_size);
+    static_int=index.locate(static_time);
+    if(static_int==TIMEINDEX_NOT_FOUND)
+    {
+        printf("static time %f is not within the recorded times !\n",static_time);
+        static_int=0;
+    }
 }
 
-void expdata::static_calibration()
+int expdata::static_calibration()
 ///******************************************************************
 /// STATIC_CALIBRATION
 /// -----------------------------------------------------------------
 /// this routine computes iteratively the relevant statistical
 /// properties from the gyro- and acceleration data which has been
-/// recorded in the initial static period
+/// recorded in the initial static period (acc_off only if the
+/// acceleration data has been loaded). returns 1 on success and 0
+/// if the static period is not set
 /// -----------------------------------------------------------------
 /// no input argument
 /// -----------------------------------------------------------------
 {
-    int i;
-    double mwa[3],ma[3];
+    double ma[3];
+    metrics_timer timer(MET_STATIC_CALIBRATION);
 
     if(static_int==0)
     {
         printf("the length of the initial static period is not set !\n");
-        exit(0);
+        return 0;
     }
 
-    for(i=0;i<=static_int;i++)
-    {
-        mwa[0]=gyro_store[i].x;
-        mwa[1]=gyro_store[i].y;
-        mwa[2]=gyro_store[i].z;
-        for(int j=0;j<3;j++) recstat::mean(ma[j],mwa[j],i+1);
-    }
+    parallel_mean(gyro_store,static_int+1,threads,ma);
     //store globally the result of the computations
     gyro_off.x=ma[0];
     gyro_off.y=ma[1];
     gyro_off.z=ma[2];
 
+    //same for the accelerometer if its data is present
+    if((int) acc_store.size()>static_int)
+    {
+        parallel_mean(acc_store,static_int+1,threads,ma);
+        acc_off.x=ma[0];
+        acc_off.y=ma[1];
+        acc_off.z=ma[2];
+    }
+    return 1;
+}
+
+void expdata::read_names(char fname[], char fname2[])
+///******************************************************************
+/// READ_NAMES
+/// -----------------------------------------------------------------
+/// reads the names of the acceleration and the gyroscopic data file
+/// from the file "dnames" unless acc_name resp. gyro_name are set
+/// (names are cut to 149 characters)
+/// -----------------------------------------------------------------
+/// fname - OUT: name of the acceleration data file
+/// fname2- OUT: name of the gyroscopic data file
+/// -----------------------------------------------------------------
+{
+    ifstream data2;
+
+    fname[0]='\0';
+    fname2[0]='\0';
+    if(acc_name==nullptr || gyro_name==nullptr)
+    {
+        data2.open("dnames");
+        data2>>fname;
+        data2>>fname2;
+        data2.close();
+    }
+    if(acc_name!=nullptr) snprintf(fname,150,"%s",acc_name);
+    if(gyro_name!=nullptr) snprintf(fname2,150,"%s",gyro_name);
+}
+
+const char *expdata::read_error(int code)
+///******************************************************************
+/// READ_ERROR
+/// -----------------------------------------------------------------
+/// returns the message for an error code of read_file
+/// -----------------------------------------------------------------
+/// code  - IN: negative return value of read_file
+/// -----------------------------------------------------------------
+{
+    return (code==RGCODEC_ERR_CORRUPT) ? "corrupt compressed file" : "could not find file";
+}
+
+int expdata::read_file(const char *fname, samplestore &store, int nthreads, int format)
+///******************************************************************
+/// READ_FILE
+/// -----------------------------------------------------------------
+/// reads a file of the format "timestamp x y z" into store and
+/// returns the number of samples read, RGCODEC_ERR_OPEN if the file
+/// could not be opened or RGCODEC_ERR_CORRUPT if a compressed file
+/// is corrupt (message: read_error). the file is split at line boundaries into one chunk
+/// per thread: the lines of each chunk are counted in parallel, the
+/// storage is allocated once and the chunks are parsed in parallel
+/// into their part of it. blank lines are skipped, missing values
+/// are set to 0. the type of the store is kept. files compressed by
+/// rgcodec are decoded, they are recognized unless format is given
+/// -----------------------------------------------------------------
+/// fname   - IN : name of the file
+/// store   - OUT: samples read
+/// nthreads- IN : number of threads (0: all cores)
+/// format  - IN : format of the file (EXPDATA_INPUT_*)
+/// -----------------------------------------------------------------
+{
+    FILE *fp;
+    long size;
+    int nt,failed=0;
+
+    //compressed recordings are decoded instead
+    if(format==EXPDATA_INPUT_AUTO) format=rgcodec::is_compressed(fname) ? EXPDATA_INPUT_RGC : EXPDATA_INPUT_TEXT;
+    if(format==EXPDATA_INPUT_RGC) return rgcodec::read_file(fname,store);
+
+    store.resize(0);
+    fp=fopen(fname,"rb");
+    if(fp==NULL) return RGCODEC_ERR_OPEN;
+    fseek(fp,0,SEEK_END);
+    size=ftell(fp);
+    fclose(fp);
+
+    //at least 1MB per chunk
+    nt=worker_count(nthreads,size/(1<<20)+1);
+    vector<long> edge(nt+1),count(nt+1,0);
+    for(int r=0;r<=nt;r++) edge[r]=(long) ((double) size*r/nt);
+
+    //first pass: number of samples per chunk
+    run_parallel(nt,[&](int r)
+    {
+        long c=0;
+        if(!for_lines(fname,edge[r],edge[r+1],[&](const char *p, const char *eol)
+                      {if(is_sample_line(p,eol)) c++;})) failed=1;
+        count[r+1]=c;
+    });
+    if(failed) return -1;
+    for(int r=0;r<nt;r++) count[r+1]+=count[r];
+    store.resize(count[nt]);
+
+    //second pass: each chunk is parsed into its part of the storage
+    run_parallel(nt,[&](int r)
+    {
+        long out=count[r];
+        dynamic s;
+        for_lines(fname,edge[r],edge[r+1],[&](const char *p, const char *eol)
+        {
+            if(out<count[r+1] && is_sample_line(p,eol))
+            {
+                parse_line(p,eol,s);
+                store.set(out++,s.t,s.x,s.y,s.z);
+            }
+        });
+    });
+    return (int) store.size();
+}
+
+bool expdata::is_sample_line(const char *p, const char *eol)
+///******************************************************************
+/// IS_SAMPLE_LINE
+/// -----------------------------------------------------------------
+/// the rule of all text loaders (read_file, the pipelined ingestion):
+/// a line is a sample if it contains anything but white space, its
+/// missing values are set to 0 by parse_line
+/// -----------------------------------------------------------------
+/// p     - IN : start of the line
+/// eol   - IN : end of the line
+/// -----------------------------------------------------------------
+{
+    for(;p<eol;p++) if(*p!=' ' && *p!='\t' && *p!='\r') return true;
+    return false;
+}
+
+int expdata::parse_line(const char *p, const char *eol, dynamic &s)
+///******************************************************************
+/// PARSE_LINE
+/// -----------------------------------------------------------------
+/// parses the line "timestamp x y z" which ends at eol into s and
+/// returns the number of values found (missing values are set to 0)
+/// -----------------------------------------------------------------
+/// p     - IN : start of the line
+/// eol   - IN : end of the line (the text must be terminated behind)
+/// s     - OUT: sample
+/// -----------------------------------------------------------------
+{
+    double v[4]={0.0,0.0,0.0,0.0};
+    char *e;
+    int k;
+
+    //strtod skips newlines as white space: numbers must end on this line
+    for(k=0;k<4;k++)
+    {
+        v[k]=strtod(p,&e);
+        if(e==p || e>eol) {v[k]=0.0; break;}
+        p=e;
+    }
+    s.t=v[0]; s.x=v[1]; s.y=v[2]; s.z=v[3];
+    return k;
+}
+
+int expdata::align_by_time(samplestore &a, samplestore &b, double tol)
+///******************************************************************
+/// ALIGN_BY_TIME
+/// -----------------------------------------------------------------
+/// merges two time series sorted by time: samples whose time stamps
+/// differ by at most tol are paired, all others are dropped. both
+/// series are replaced by the paired samples and the number of
+/// pairs is returned
+/// -----------------------------------------------------------------
+/// a,b   - INOUT: time series to be aligned
+/// tol   - IN   : tolerance of the time stamps
+/// -----------------------------------------------------------------
+{
+    size_t ia=0,ib=0,n=0;
+
+    //in place: the write position n never overtakes ia or ib
+    while(ia<a.size() && ib<b.size())
+    {
+        if(fabs(a.time(ia)-b.time(ib))<=tol)
+        {
+            a.copy_sample(n,ia++);
+            b.copy_sample(n,ib++);
+            n++;
+        }
+        else if(a.time(ia)<b.time(ib)) ia++;
+        else ib++;
+    }
+    a.resize(n);
+    b.resize(n);
+    return (int) n;
 }
 
+int expdata::read_data_joint()
+///******************************************************************
+/// READ_DATA_JOINT
+/// -----------------------------------------------------------------
+/// loads both files given by name in the file "dnames" (acceleration
+/// and gyroscopic data) in parallel and aligns them by their time
+/// stamps such that sample i of gyro_store and acc_store belong to the
+/// same instant. samples without partner are dropped. both stores
+/// use the type of gyro_store. returns 1 on success and 0 if a file
+/// could not be read
+/// -----------------------------------------------------------------
+/// no (direct) input arguments
+/// -----------------------------------------------------------------
+{
+    char fname[150],fname2[150];
+    int nacc=-1,ngyro,n;
+    double tol;
+    metrics_timer timer(MET_READ_DATA);
+
+    read_names(fname,fname2);
+    acc_store.set_type(gyro_store.storage());
+
+    //acceleration data on a second thread, gyroscopic data on this one
+    printf("loading acc-data from file: %s\n",fname);
+    printf("loading gyro-data from file: %s\n",fname2);
+    thread loader([&](){nacc=read_file(fname,acc_store,threads,input_format);});
+    ngyro=read_file(fname2,gyro_store,threads,input_format);
+    loader.join();
+
+    if(nacc<0 || ngyro<0)
+    {
+        printf("%s: %s\n",read_error((nacc<0) ? nacc : ngyro),(nacc<0) ? fname : fname2);
+        data_size=0;
+        return 0;
+    }
+    metrics::add(MET_SAMPLES_READ,nacc+ngyro);
+
+    //pair samples closer than half the mean sampling interval of the gyro
+    tol=(ngyro>1) ? 0.5*(gyro_store.time(ngyro-1)-gyro_store.time(0))/(ngyro-1) : 0.0;
+    n=align_by_time(gyro_store,acc_store,tol);
+    if(n<ngyro || n<nacc) printf("aligned %d samples (dropped %d gyro and %d acc samples)\n",n,ngyro-n,nacc-n);
+
+    data_size=n;
+    return 1;
+}
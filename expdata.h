@@ -25,6 +25,12 @@
 #include <stdlib.h>
 using namespace std;
 #include "math.h"
+#include "samplestore.h"
+
+//format of the data files
+#define EXPDATA_INPUT_AUTO 0          //recognized from the file (rgcodec::is_compressed)
+#define EXPDATA_INPUT_TEXT 1          //"t x y z" text
+#define EXPDATA_INPUT_RGC 2           //compressed by rgcodec
 
 class expdata {
 
@@ -53,11 +59,19 @@ public:
         double z;
     } dynamic;
 
-    //storage_arrays for the data which has been read
-    std::vector<dynamic> gyro_store;  //storage for the gyroscopic data
+    //columnar storage for the data which has been read (including the readout times)
+    samplestore gyro_store;           //storage for the gyroscopic data
+    samplestore acc_store;            //storage for the acceleration data (only filled by read_data_joint)
     state gyro_off;                   //storage for the offset of the gyroscope after the static period
-    double  *global_times;            //storage for the readout times
-    int data_size;                    //number of data points that have been read
+    state acc_off;                    //storage for the bias of the accelerometer after the static period
+    int data_size=0;                  //number of data points that have been read
+    int threads=0;                    //worker threads for loading and static calibration (0: all cores)
+
+    //names of the data files set by the front-end (runconfig), they take
+    //precedence over the file "dnames" (nullptr: the name from "dnames")
+    static const char *acc_name;
+    static const char *gyro_name;
+    static int input_format;          //format of both files (EXPDATA_INPUT_*)
 
     //*******************************************************************
     //declarations follow below
@@ -66,19 +80,119 @@ public:
     /// READ_DATA
     /// -----------------------------------------------------------------
     /// loads data from the files that are given by name in the file
-    /// "dnames" this data is then stored in the global arrays acc_store
-    /// and gyro_store. Additionally a global time-array is used.
+    /// "dnames" this data is then stored in the columnar store
+    /// gyro_store (type of the components as set in gyro_store).
+    /// returns 1 on success and 0 if the file could not be read
+    /// -----------------------------------------------------------------
+    /// no (direct) input arguments
+    /// -----------------------------------------------------------------
+
+    int read_data(bool verbose=true);
+
+    ///******************************************************************
+    /// READ_DATA_JOINT
+    /// -----------------------------------------------------------------
+    /// loads both files given by name in the file "dnames" (acceleration
+    /// and gyroscopic data) in parallel and aligns them by their time
+    /// stamps such that sample i of gyro_store and acc_store belong to the
+    /// same instant. samples without partner are dropped. both stores
+    /// use the type of gyro_store. returns 1 on success and 0 if a file
+    /// could not be read
     /// -----------------------------------------------------------------
     /// no (direct) input arguments
     /// -----------------------------------------------------------------
 
-    void read_data();
+    int read_data_joint();
+
+    ///******************************************************************
+    /// READ_NAMES
+    /// -----------------------------------------------------------------
+    /// reads the names of the acceleration and the gyroscopic data file
+    /// from the file "dnames" unless acc_name resp. gyro_name are set
+    /// (names are cut to 149 characters)
+    /// -----------------------------------------------------------------
+    /// fname - OUT: name of the acceleration data file
+    /// fname2- OUT: name of the gyroscopic data file
+    /// -----------------------------------------------------------------
+
+    static void read_names(char fname[], char fname2[]);
+
+    ///******************************************************************
+    /// READ_FILE
+    /// -----------------------------------------------------------------
+    /// reads a file of the format "timestamp x y z" into store and
+    /// returns the number of samples read, RGCODEC_ERR_OPEN if the file
+    /// could not be opened or RGCODEC_ERR_CORRUPT if a compressed file
+    /// is corrupt (message: read_error). the file is split at line boundaries into one chunk
+    /// per thread: the lines of each chunk are counted in parallel, the
+    /// storage is allocated once and the chunks are parsed in parallel
+    /// into their part of it. blank lines are skipped, missing values
+    /// are set to 0. the type of the store is kept. files compressed by
+    /// rgcodec are decoded, they are recognized unless format is given
+    /// -----------------------------------------------------------------
+    /// fname   - IN : name of the file
+    /// store   - OUT: samples read
+    /// nthreads- IN : number of threads (0: all cores)
+    /// format  - IN : format of the file (EXPDATA_INPUT_*)
+    /// -----------------------------------------------------------------
+
+    static int read_file(const char *fname, samplestore &store, int nthreads=0, int format=EXPDATA_INPUT_AUTO);
+
+    ///******************************************************************
+    /// READ_ERROR
+    /// -----------------------------------------------------------------
+    /// returns the message for an error code of read_file
+    /// -----------------------------------------------------------------
+    /// code  - IN: negative return value of read_file
+    /// -----------------------------------------------------------------
+
+    static const char *read_error(int code);
+
+    ///******************************************************************
+    /// IS_SAMPLE_LINE
+    /// -----------------------------------------------------------------
+    /// the rule of all text loaders (read_file, the pipelined ingestion):
+    /// a line is a sample if it contains anything but white space, its
+    /// missing values are set to 0 by parse_line
+    /// -----------------------------------------------------------------
+    /// p     - IN : start of the line
+    /// eol   - IN : end of the line
+    /// -----------------------------------------------------------------
+
+    static bool is_sample_line(const char *p, const char *eol);
+
+    ///******************************************************************
+    /// PARSE_LINE
+    /// -----------------------------------------------------------------
+    /// parses the line "timestamp x y z" which ends at eol into s and
+    /// returns the number of values found (missing values are set to 0)
+    /// -----------------------------------------------------------------
+    /// p     - IN : start of the line
+    /// eol   - IN : end of the line (the text must be terminated behind)
+    /// s     - OUT: sample
+    /// -----------------------------------------------------------------
+
+    static int parse_line(const char *p, const char *eol, dynamic &s);
+
+    ///******************************************************************
+    /// ALIGN_BY_TIME
+    /// -----------------------------------------------------------------
+    /// merges two time series sorted by time: samples whose time stamps
+    /// differ by at most tol are paired, all others are dropped. both
+    /// series are replaced by the paired samples and the number of
+    /// pairs is returned
+    /// -----------------------------------------------------------------
+    /// a,b   - INOUT: time series to be aligned
+    /// tol   - IN   : tolerance of the time stamps
+    /// -----------------------------------------------------------------
+
+    static int align_by_time(samplestore &a, samplestore &b, double tol);
 
     ///******************************************************************
     /// SET_STATIC_INT
     /// -----------------------------------------------------------------
-    /// compute the length of the initial static period by bisection on
-    /// the table of input-times
+    /// compute the length of the initial static period by a search on
+    /// the time column of gyro_store (class timeindex)
     /// -----------------------------------------------------------------
     /// no input argument
     /// -----------------------------------------------------------------
@@ -90,13 +204,17 @@ public:
     /// -----------------------------------------------------------------
     /// this routine computes iteratively the relevant statistical
     /// properties from the gyro- and acceleration data which has been
-    /// recorded in the initial static period
+    /// recorded in the initial static period (acc_off only if the
+    /// acceleration data has been loaded). the means are computed as a
+    /// parallel reduction over fixed blocks of samples, such that the
+    /// result does not depend on the number of threads. returns 1 on
+    /// success and 0 if the static period is not set
     /// -----------------------------------------------------------------
     /// no input argument
     /// -----------------------------------------------------------------
 
 
-    void static_calibration();
+    int static_calibration();
 
 };
 
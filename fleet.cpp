@@ -0,0 +1,234 @@
+//
+// Created by stefan on 14.04.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "fleet.h"
+#include "recstats.h"
+#include "math.h"
+#include <math.h>
+#include <algorithm>
+
+void fleet::setup(int nd)
+///******************************************************************
+/// SETUP
+/// -----------------------------------------------------------------
+/// creates nd devices without samples
+/// -----------------------------------------------------------------
+/// nd    - IN: number of devices
+/// -----------------------------------------------------------------
+{
+    dev.assign(nd,device());
+    order.resize(nd);
+    for(int k=0;k<nd;k++)
+    {
+        device &d=dev[k];
+        for(int j=0;j<3;j++) for(int l=0;l<4;l++) d.stat[j][l]=0.0;
+        d.n=0;
+        d.converged=0;
+        d.stride=1;
+        d.seen=0;
+        d.shed=0;
+        d.t_first=0.0;
+        d.queue.assign(3*(size_t) queue_capacity,0.0);
+        d.head=0;
+        d.count=0;
+        d.remaining=(double) min_runs;
+        d.margin=-prop_chosen;
+        order[k]=k;
+    }
+    latency.clear();
+    converged=0;
+    updates=0;
+    shed=0;
+    z=mathb::erfinv(prop_chosen);
+}
+
+void fleet::estimate(device &d)
+//estimate of the samples still needed: the acceptance probability of a component
+//reaches prop_chosen once f*|m|/sqrt(2*v) >= erfinv(prop_chosen); with v ~ 1/n
+//this happens after n*v/v_target samples
+{
+    recstat recstats;
+    double need=(double) (min_runs-(d.n+1)),vt,p,pmin=1.1;
+
+    for(int j=0;j<3;j++)
+    {
+        if(d.n<2) continue;
+        vt=0.5*pow(fractional_chosen*d.stat[j][2]/z,2);
+        if(d.stat[j][3]>0.0 && vt>0.0) need=max(need,(double) d.n*(d.stat[j][3]/vt-1.0));
+        p=recstats.seq_accept_probability(d.stat[j],fractional_chosen);
+        if(pmin>=p) pmin=p;
+    }
+    d.remaining=max(need,0.0);
+    d.margin=((d.n<2) ? 0.0 : pmin)-prop_chosen;
+}
+
+int fleet::update(device &d, double now)
+//passes the oldest queued sample of d through its recursion, returns 1 on convergence
+{
+    recstat recstats;
+    double min=1.1,p;
+    const double *x=&d.queue[3*(size_t) d.head];
+
+    d.head=(d.head+1)%queue_capacity;
+    d.count--;
+    d.n++;
+    updates++;
+    for(int j=0;j<3;j++)
+    {
+        recstats.seq_update(d.stat[j],x[j],d.n);
+        p=recstats.seq_accept_probability(d.stat[j],fractional_chosen);
+        if(min>=p) min=p;
+    }
+    //same criterion as in main.cpp (the run counter there is n+1)
+    if(min<prop_chosen || d.n+1<min_runs) return 0;
+
+    d.converged=1;
+    d.count=0;
+    converged++;
+    latency.push_back(now-d.t_first);
+    return 1;
+}
+
+int fleet::push(int d, const double x[], double now)
+///******************************************************************
+/// PUSH
+/// -----------------------------------------------------------------
+/// queues the sample x[0..2] of device d which arrived at time now.
+/// returns 1 if it was queued and 0 if it was dropped (device
+/// converged, subsampled or queue full)
+/// -----------------------------------------------------------------
+/// d     - IN: device
+/// x     - IN: sample (three components)
+/// now   - IN: time of arrival
+/// -----------------------------------------------------------------
+{
+    device &dv=dev[d];
+    int tail;
+
+    if(dv.converged) return 0;
+    if(dv.seen==0) dv.t_first=now;
+    dv.seen++;
+    //overload: subsample the stream, then shed; the stride is widened
+    //at most once per stride samples so that streams are shed gradually
+    if(dv.count>=queue_capacity && dv.stride<FLEET_MAX_STRIDE && dv.seen%dv.stride==0) dv.stride*=2;
+    if(dv.seen%dv.stride!=0 || dv.count>=queue_capacity)
+    {
+        dv.shed++;
+        shed++;
+        return 0;
+    }
+    tail=(dv.head+dv.count)%queue_capacity;
+    for(int j=0;j<3;j++) dv.queue[3*(size_t) tail+j]=x[j];
+    dv.count++;
+    return 1;
+}
+
+long fleet::schedule(long budget, double now)
+///******************************************************************
+/// SCHEDULE
+/// -----------------------------------------------------------------
+/// passes at most budget queued samples through the recursions,
+/// devices closest to convergence first, and returns the number of
+/// samples processed
+/// -----------------------------------------------------------------
+/// budget- IN: largest number of updates
+/// now   - IN: current time (for the latencies)
+/// -----------------------------------------------------------------
+{
+    long done=0;
+    int na=0,lane[FLEET_GROUP],nl,busy;
+
+    //waiting devices, ranked by the estimated samples still needed
+    for(int k=0;k<(int) dev.size();k++)
+    {
+        if(dev[k].converged || dev[k].count==0) continue;
+        if(prioritize) estimate(dev[k]);
+        order[na++]=k;
+    }
+    if(prioritize)
+    {
+        sort(order.begin(),order.begin()+na,[this](int a, int b)
+        {
+            if(dev[a].remaining!=dev[b].remaining) return dev[a].remaining<dev[b].remaining;
+            if(dev[a].margin!=dev[b].margin) return dev[a].margin>dev[b].margin;
+            return a<b;
+        });
+    }
+
+    //groups in order of priority: the recursions of a group are independent
+    //and are interleaved one sample per device and round
+    for(int g=0;g<na && done<budget;g+=FLEET_GROUP)
+    {
+        nl=min(FLEET_GROUP,na-g);
+        for(int l=0;l<nl;l++) lane[l]=order[g+l];
+        do
+        {
+            busy=0;
+            for(int l=0;l<nl && done<budget;l++)
+            {
+                device &d=dev[lane[l]];
+                if(d.converged || d.count==0) continue;
+                update(d,now);
+                done++;
+                busy++;
+            }
+        } while(busy>0 && done<budget);
+        //drained queues: the subsampling is relaxed again
+        for(int l=0;l<nl;l++)
+        {
+            device &d=dev[lane[l]];
+            if(d.count==0 && d.stride>1) d.stride/=2;
+        }
+    }
+    return done;
+}
+
+double fleet::latency_percentile(double q) const
+///******************************************************************
+/// LATENCY_PERCENTILE
+/// -----------------------------------------------------------------
+/// returns the q-quantile (nearest rank, 0<q<=1) of the latencies of
+/// the converged devices or -1 if no device has converged
+/// -----------------------------------------------------------------
+/// q     - IN: quantile
+/// -----------------------------------------------------------------
+{
+    vector<double> l(latency);
+    size_t r;
+
+    if(l.empty()) return -1.0;
+    r=(size_t) ceil(q*(double) l.size());
+    if(r<1) r=1;
+    if(r>l.size()) r=l.size();
+    nth_element(l.begin(),l.begin()+(r-1),l.end());
+    return l[r-1];
+}
+
+int fleet::offset(int d, double offset[]) const
+///******************************************************************
+/// OFFSET
+/// -----------------------------------------------------------------
+/// returns 1 and the offsets of device d if it has converged and 0
+/// otherwise
+/// -----------------------------------------------------------------
+/// d     - IN : device
+/// offset- OUT: offsets of the three components
+/// -----------------------------------------------------------------
+{
+    const device &dv=dev[d];
+
+    for(int j=0;j<3;j++) offset[j]=dv.stat[j][2];
+    return dv.converged;
+}
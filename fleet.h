@@ -0,0 +1,143 @@
+//
+// Created by stefan on 14.04.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_FLEET_H
+#define PUBLICATION_RECURSIVE_MEAN_FLEET_H
+
+#include <vector>
+using namespace std;
+
+#define FLEET_GROUP 8                 //devices updated together (interleaved)
+#define FLEET_MAX_STRIDE 16           //largest subsampling factor under overload
+
+//*******************************************************************
+// calibration of many devices on one host. Each device has its own
+// recursion (recstat::seq_update for three components) fed from a
+// bounded queue of incoming samples. schedule spends a budget of
+// updates on the devices closest to convergence first: the number
+// of samples still needed is estimated from the variance of the mean,
+// which falls roughly like 1/n, and ties are broken by the margin of
+// the acceptance probability. Devices are updated in groups whose
+// independent recursions are interleaved sample by sample. Converged
+// devices are retired at once. Under overload the queues of the low
+// priority devices fill up: their streams are first subsampled (every
+// stride-th sample, which keeps the samples independent) and then
+// shed. The latency from the first sample to convergence is recorded
+// for every device.
+//*******************************************************************
+
+class fleet {
+
+private:
+
+    typedef struct fleet_device
+    {
+        double stat[3][4];    //recursion of the three components
+        int n;                //samples in the recursion
+        int converged;        //1 once converged
+        int stride;           //subsampling factor (1: every sample)
+        long seen;            //samples arrived
+        long shed;            //samples dropped (subsampled or queue full)
+        double t_first;       //arrival time of the first sample
+        vector<double> queue; //ring of queued samples (3 values each)
+        int head,count;       //ring position and fill
+        double remaining;     //estimated samples to convergence
+        double margin;        //lowest acceptance probability minus prop_chosen
+    } device;
+
+    vector<device> dev;
+    vector<int> order;
+    vector<double> latency;   //latencies of the converged devices
+    double z=0.0;             //erfinv(prop_chosen)
+
+    void estimate(device &d);
+    int update(device &d, double now);
+
+public:
+
+    double prop_chosen=0.9;   //acceptance probability
+    double fractional_chosen=0.005; //fractional accuracy
+    int min_runs=100;         //minimum number of samples
+    int queue_capacity=256;   //samples per device queue
+    bool prioritize=true;     //false: devices in index order (for comparison)
+    int converged=0;          //number of converged devices
+    long updates=0;           //samples passed through the recursions
+    long shed=0;              //samples dropped in total
+
+    ///******************************************************************
+    /// SETUP
+    /// -----------------------------------------------------------------
+    /// creates nd devices without samples
+    /// -----------------------------------------------------------------
+    /// nd    - IN: number of devices
+    /// -----------------------------------------------------------------
+
+    void setup(int nd);
+
+    ///******************************************************************
+    /// PUSH
+    /// -----------------------------------------------------------------
+    /// queues the sample x[0..2] of device d which arrived at time now.
+    /// returns 1 if it was queued and 0 if it was dropped (device
+    /// converged, subsampled or queue full)
+    /// -----------------------------------------------------------------
+    /// d     - IN: device
+    /// x     - IN: sample (three components)
+    /// now   - IN: time of arrival
+    /// -----------------------------------------------------------------
+
+    int push(int d, const double x[], double now);
+
+    ///******************************************************************
+    /// SCHEDULE
+    /// -----------------------------------------------------------------
+    /// passes at most budget queued samples through the recursions,
+    /// devices closest to convergence first, and returns the number of
+    /// samples processed
+    /// -----------------------------------------------------------------
+    /// budget- IN: largest number of updates
+    /// now   - IN: current time (for the latencies)
+    /// -----------------------------------------------------------------
+
+    long schedule(long budget, double now);
+
+    ///******************************************************************
+    /// LATENCY_PERCENTILE
+    /// -----------------------------------------------------------------
+    /// returns the q-quantile (nearest rank, 0<q<=1) of the latencies of
+    /// the converged devices or -1 if no device has converged
+    /// -----------------------------------------------------------------
+    /// q     - IN: quantile
+    /// -----------------------------------------------------------------
+
+    double latency_percentile(double q) const;
+
+    ///******************************************************************
+    /// OFFSET
+    /// -----------------------------------------------------------------
+    /// returns 1 and the offsets of device d if it has converged and 0
+    /// otherwise
+    /// -----------------------------------------------------------------
+    /// d     - IN : device
+    /// offset- OUT: offsets of the three components
+    /// -----------------------------------------------------------------
+
+    int offset(int d, double offset[]) const;
+
+    int size() const {return (int) dev.size();}
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_FLEET_H
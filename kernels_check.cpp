@@ -0,0 +1,295 @@
+//
+// Created by stefan on 14.02.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+//host-side harness for the embedded kernels of reckernels.h: the synthetic
+//data of main.cpp and the experimental data given in "dnames" are replayed
+//through the double precision reference (recstat), the single precision
+//(recstatf) and the fixed-point (recstatq) version of the recursion. The
+//maximum deviations from the reference and the cost per sample are reported.
+//The long-horizon recursion (recstat::seq_update_long) is compared in the same
+//way and, over a long synthetic stream (default 2^26 samples or the count given
+//as argument), against an extended precision evaluation of the recursion.
+
+#include "baserandom.h"
+#include "recstats.h"
+#include "reckernels.h"
+#include "expdata.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define KERNELS_TICK_UNIT "cycles"
+#else
+#define KERNELS_TICK_UNIT "ns"
+#endif
+using namespace std;
+
+//time stamp counter if available, monotonic nanoseconds otherwise
+static inline unsigned long long ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (unsigned long long) chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+//result of one replay of a single time series through one of the kernels
+typedef struct replay_result
+{
+    vector<double> offset;   //mean of mean after each sample
+    vector<double> prob;     //acceptance probability after each sample
+    int iconv;               //index of first convergence as counted in main.cpp
+    double tick_per_sample;  //cost per sample (update+acceptance probability)
+} replay;
+
+static const double prop_chosen=0.9;
+static const double fractional_chosen=0.005;
+
+static void check_convergence(replay &r)
+{
+    r.iconv=-1;
+    for(size_t k=0;k<r.prob.size();k++)
+    {
+        //k+2 corresponds to the counter i of main.cpp after the increment
+        if(r.prob[k]>=prop_chosen && (int) k+2>=100) {r.iconv=(int) k+2; break;}
+    }
+}
+
+static replay run_double(const vector<double> &x)
+{
+    replay r;
+    recstat rs;
+    double stat[4]={0.0,0.0,0.0,0.0};
+    volatile double sink=0.0;
+    unsigned long long t0;
+    int n=(int) x.size();
+
+    r.offset.resize(n);
+    r.prob.resize(n);
+    t0=ticks();
+    for(int i=0;i<n;i++)
+    {
+        rs.seq_update(stat,x[i],i+1);
+        r.prob[i]=rs.seq_accept_probability(stat,fractional_chosen);
+        r.offset[i]=stat[2];
+    }
+    r.tick_per_sample=(double) (ticks()-t0)/n;
+    sink=r.offset[n-1];
+    (void) sink;
+    check_convergence(r);
+    return r;
+}
+
+static replay run_long(const vector<double> &x)
+{
+    replay r;
+    recstat rs;
+    double stat[RECSTAT_LONG_SIZE]={0.0};
+    unsigned long long t0;
+    int n=(int) x.size();
+
+    r.offset.resize(n);
+    r.prob.resize(n);
+    t0=ticks();
+    for(int i=0;i<n;i++)
+    {
+        rs.seq_update_long(stat,x[i],(int64_t) i+1);
+        r.prob[i]=rs.seq_accept_probability(stat,fractional_chosen);
+        r.offset[i]=stat[2];
+    }
+    r.tick_per_sample=(double) (ticks()-t0)/n;
+    check_convergence(r);
+    return r;
+}
+
+static replay run_float(const vector<double> &x)
+{
+    replay r;
+    recstatf rs;
+    vector<float> xf(x.size());
+    unsigned long long t0;
+    int n=(int) x.size();
+    float f=(float) fractional_chosen;
+
+    for(int i=0;i<n;i++) xf[i]=(float) x[i];
+    r.offset.resize(n);
+    r.prob.resize(n);
+    t0=ticks();
+    for(int i=0;i<n;i++)
+    {
+        rs.seq_update(xf[i],i+1);
+        r.prob[i]=rs.seq_accept_probability(f);
+        r.offset[i]=rs.offset();
+    }
+    r.tick_per_sample=(double) (ticks()-t0)/n;
+    check_convergence(r);
+    return r;
+}
+
+static replay run_fixed(const vector<double> &x)
+{
+    replay r;
+    recstatq rs;
+    vector<int32_t> xq(x.size());
+    unsigned long long t0;
+    int n=(int) x.size();
+    int32_t f=(int32_t) lround(fractional_chosen*(double) (1<<RECQ_FRAC_BITS));
+    const double pscale=1.0/(double) (1<<RECQ_PROB_BITS);
+
+    for(int i=0;i<n;i++) xq[i]=(int32_t) lround(x[i]*(double) (1<<RECQ_DATA_BITS));
+    r.offset.resize(n);
+    r.prob.resize(n);
+    t0=ticks();
+    for(int i=0;i<n;i++)
+    {
+        rs.seq_update(xq[i],i+1);
+        r.prob[i]=pscale*rs.seq_accept_probability(f);
+        r.offset[i]=rs.offset();
+    }
+    r.tick_per_sample=(double) (ticks()-t0)/n;
+    check_convergence(r);
+    return r;
+}
+
+static void report(const char *name, const replay &ref, const replay &r)
+{
+    double doff=0.0,drel=0.0,dprob=0.0;
+
+    for(size_t k=0;k<r.offset.size();k++)
+    {
+        doff=fmax(doff,fabs(r.offset[k]-ref.offset[k]));
+        drel=fmax(drel,fabs(r.offset[k]-ref.offset[k])/fabs(ref.offset[k]));
+        dprob=fmax(dprob,fabs(r.prob[k]-ref.prob[k]));
+    }
+    printf("  %-7s max|d offset|=%e (relative x 10(6): %f) max|d prob|=%e converged(i=%d) %.1f %s/sample\n",
+           name,doff,1.0e6*drel,dprob,r.iconv,r.tick_per_sample,KERNELS_TICK_UNIT);
+}
+
+static void compare(const char *name, const vector<double> &x)
+{
+    replay rd,rl,rf,rq;
+
+    rd=run_double(x);
+    rl=run_long(x);
+    rf=run_float(x);
+    rq=run_fixed(x);
+    printf("%s (%d samples):\n",name,(int) x.size());
+    printf("  %-7s offset=%f converged(i=%d) %.1f %s/sample\n",
+           "double",rd.offset.back(),rd.iconv,rd.tick_per_sample,KERNELS_TICK_UNIT);
+    report("long",rd,rl);
+    report("float",rd,rf);
+    report("fixed",rd,rq);
+}
+
+//recursion of seq_update evaluated in extended precision as reference
+static void seq_update_ext(long double s[], long double x, int64_t n)
+{
+    long double nd=(long double) n,nd1=nd-1.0L;
+
+    s[0]=(nd1*s[0]+x)/nd;
+    if(n>1) s[1]=((nd1-1.0L)/nd1)*s[1]+(nd/(nd1*nd1))*(x-s[0])*(x-s[0]);
+    s[2]=(nd1*s[2]+s[0])/nd;
+    if(n>1) s[3]=((nd1-1.0L)/nd1)*s[3]+(nd/(nd1*nd1))*(s[0]-s[2])*(s[0]-s[2]);
+}
+
+//long synthetic stream (uniform noise of the variance of main.cpp around an
+//offset) through seq_update and seq_update_long in blocks; the relative
+//deviations of the mean, the offset (mean of mean) and the variance from the
+//reference are printed at every power of two, followed by the cost per update
+static void long_horizon(int64_t nlong)
+{
+    recstat rs;
+    double sd[4]={0.0,0.0,0.0,0.0},sl[RECSTAT_LONG_SIZE]={0.0},b=sqrt(12*979.56);
+    long double se[4]={0.0L,0.0L,0.0L,0.0L};
+    uint64_t state=88172645463325252ULL;
+    unsigned long long t0,tick[2]={0,0};
+    const int nblock=1<<16;
+    vector<double> x(nblock);
+
+    printf("long horizon (%lld samples), relative deviation from extended precision:\n",(long long) nlong);
+    printf("  %12s %12s %12s %12s %12s %12s %12s\n","n","mean","mean(long)","offset","offset(long)","var","var(long)");
+    for(int64_t n0=0;n0<nlong;n0+=nblock)
+    {
+        int m=(int) min((int64_t) nblock,nlong-n0);
+        for(int k=0;k<m;k++)
+        {
+            //xorshift64 uniform in [0,1)
+            state^=state<<13; state^=state>>7; state^=state<<17;
+            x[k]=35634.458+((double) (state>>11)*(1.0/9007199254740992.0)-0.5)*b;
+        }
+        t0=ticks();
+        for(int k=0;k<m;k++) rs.seq_update(sd,x[k],(int) (n0+k+1));
+        tick[0]+=ticks()-t0;
+        t0=ticks();
+        for(int k=0;k<m;k++) rs.seq_update_long(sl,x[k],n0+k+1);
+        tick[1]+=ticks()-t0;
+        for(int k=0;k<m;k++) seq_update_ext(se,(long double) x[k],n0+k+1);
+
+        int64_t n=n0+m;
+        if((n&(n-1))==0 && n>=nblock)
+        {
+            printf("  %12lld %12.3e %12.3e %12.3e %12.3e %12.3e %12.3e\n",(long long) n,
+                   (double) fabsl((sd[0]-se[0])/se[0]),(double) fabsl((sl[0]-se[0])/se[0]),
+                   (double) fabsl((sd[2]-se[2])/se[2]),(double) fabsl((sl[2]-se[2])/se[2]),
+                   (double) fabsl((sd[1]-se[1])/se[1]),(double) fabsl((sl[1]-se[1])/se[1]));
+        }
+    }
+    printf("  cost per update: seq_update %.1f %s, seq_update_long %.1f %s (%+.1f%%)\n",
+           (double) tick[0]/nlong,KERNELS_TICK_UNIT,(double) tick[1]/nlong,KERNELS_TICK_UNIT,
+           100.0*((double) tick[1]/(double) tick[0]-1.0));
+}
+
+int main(int argc, char *argv[])
+{
+    ranbase randy;
+    expdata exp;
+    vector<double> gauss,uniform,axis[3];
+    double a,b;
+    const int nsynth=100000;
+
+    //synthetic data with the parameters of main.cpp
+    randy.initialize_random_generators(1);
+    b=sqrt(12*979.56);
+    a=35634.458-0.5*b;
+    gauss.resize(nsynth);
+    uniform.resize(nsynth);
+    for(int i=0;i<nsynth;i++)
+    {
+        gauss[i]=35747.234+987.34*randy.ran_gauss();
+        uniform[i]=a+randy.ran_short()*b;
+    }
+    compare("synthetic gauss",gauss);
+    compare("synthetic uniform",uniform);
+
+    //experimental data
+    if(exp.read_data()==0) return 1;
+    for(int j=0;j<3;j++)
+    {
+        axis[j].resize(exp.data_size);
+        exp.gyro_store.copy_axis(j,0,exp.data_size,axis[j].data());
+    }
+    compare("experimental x",axis[0]);
+    compare("experimental y",axis[1]);
+    compare("experimental z",axis[2]);
+
+    long_horizon((argc>1) ? atoll(argv[1]) : ((int64_t) 1<<26));
+
+    return 0;
+}
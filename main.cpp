@@ -18,16 +18,1066 @@
 #include "baserandom.h"
 #include "recstats.h"
 #include "expdata.h"
+#include "opgrid.h"
+#include "tracer.h"
+#include "metrics.h"
+#include "decimator.h"
+#include "tempcache.h"
+#include "pipeline.h"
+#include "rgcodec.h"
+#include "fleet.h"
+#include "recdrift.h"
+#include "bootstrap.h"
+#include "rectime.h"
+#include "multichan.h"
+#include "runconfig.h"
+#include "calibrator.h"
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 using namespace std;
 
 //Details of the algorithm and especially the mathematical basis of the algorithm can be found in the paper:
 // "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
 
-int main()
+//keys of runconfig used by a mode (by the default run for NULL)
+static const char *mode_keys(const char *mode)
+{
+    const char *modes[]={"sweep","joint","pipelined","run","fleet","compress","tempcal","drift","channels","bootstrap"};
+    const char *keys[]={"static-time min-runs threads gyro input fgrid pgrid metrics storage",
+                        "prop fractional static-time min-runs threads gyro acc input metrics storage",
+                        "prop fractional static-time min-runs gyro input metrics",
+                        "prop fractional static-time min-runs threads gyro input engine output repeat metrics storage",
+                        "prop fractional min-runs rng seed metrics",
+                        "threads metrics",
+                        "prop fractional min-runs threads gyro input metrics storage",
+                        "prop fractional static-time min-runs rng seed threads gyro input metrics storage",
+                        "prop fractional static-time min-runs rng seed threads gyro input metrics storage",
+                        "prop fractional static-time min-runs seed threads gyro input metrics storage"};
+
+    if(mode==NULL) return "prop fractional static-time min-runs rng seed threads gyro input metrics storage "
+                          "trace trace-capacity trace-drop robust decimate";
+    for(int k=0;k<10;k++) if(strcmp(mode,modes[k])==0) return keys[k];
+    //irregular, spikes: experimental data, static reference and seed of the injected faults
+    return "prop fractional static-time min-runs seed threads gyro input metrics storage";
+}
+
+//largest number of arguments of a mode (nmin: smallest), -1 if mode is none
+static int mode_args(const char *mode, int &nmin)
+{
+    const char *modes[]={"sweep","joint","pipelined","run","drift","irregular","fleet","bootstrap","channels","spikes","tempcal","compress"};
+    const int nmax[]={0,0,0,0,0,0,1,1,1,1,2,2},nreq[]={0,0,0,0,0,0,0,0,0,0,1,2};
+
+    for(int k=0;k<12;k++)
+    {
+        if(strcmp(mode,modes[k])!=0) continue;
+        nmin=nreq[k];
+        return nmax[k];
+    }
+    return -1;
+}
+
+//optional argument k of a mode, NULL if it is missing or an option
+static const char *mode_arg(int argc, char *argv[], int k)
+{
+    return (k<argc && strncmp(argv[k],"--",2)!=0) ? argv[k] : NULL;
+}
+
+//loads the experimental data of cfg into exp (for joint both files aligned
+//by time) and computes the static reference of the gyroscope into ref[0..2]
+//(for joint that of the accelerometer into ref[3..5]); returns 1 on success
+//and 0 on an error, which has been reported
+static int load_experiment(const runconfig &cfg, expdata &exp, double ref[], bool joint=false, bool verbose=true)
+{
+    exp.threads=cfg.threads;
+    exp.gyro_store.set_type(cfg.storage);
+    if((joint ? exp.read_data_joint() : exp.read_data(verbose))==0) return 0;
+    exp.static_time=cfg.static_time;
+    exp.set_static_int();
+    if(exp.static_calibration()==0) return 0;
+    ref[0]=exp.gyro_off.x; ref[1]=exp.gyro_off.y; ref[2]=exp.gyro_off.z;
+    if(joint) {ref[3]=exp.acc_off.x; ref[4]=exp.acc_off.y; ref[5]=exp.acc_off.z;}
+    return 1;
+}
+
+//sets up randy for the synthetic data of a mode as in the default run: ran_gauss
+//uses the generator rng unless it is set in cfg and the generators start from
+//the seed of cfg (verbose: the generator is reported)
+static void setup_random(const runconfig &cfg, ranbase &randy, int rng, bool verbose=true)
+{
+    int rc=cfg.is_set("rng") ? cfg.rng : rng;
+
+    if(verbose) randy.initialize_random_generators(rc);
+    if(!verbose || cfg.seed!=1) randy.initialize_stream(rc,cfg.seed);
+}
+
+//*************************************************
+//sweep over a grid of operating points: the recursion
+//is run once over the experimental data and every pair
+//of fractional accuracy and acceptance probability
+//("--fgrid", "--pgrid") is evaluated on the fly, the
+//offsets are compared with the static reference (call
+//with argument "sweep")
+//*************************************************
+static int sweep_operating_points(const runconfig &cfg)
+{
+    int i;
+    double xstat[4],ystat[4],zstat[4],ref[3];
+    double *stat[3]={xstat,ystat,zstat};
+    recstat recstats;
+    expdata exp;
+    opgrid grid;
+
+    printf("#START OF OPERATING POINT SWEEP WITH EXPERIMENTAL DATA...\n");
+    if(load_experiment(cfg,exp,ref)==0) return 1;
+    grid.min_runs=cfg.min_runs;
+    grid.setup(cfg.fgrid.data(),(int) cfg.fgrid.size(),cfg.pgrid.data(),(int) cfg.pgrid.size(),3);
+
+    i=1;
+    while(i<=exp.data_size)
+    {
+        recstats.seq_update(xstat,exp.gyro_store.get(0,i-1),i);
+        recstats.seq_update(ystat,exp.gyro_store.get(1,i-1),i);
+        recstats.seq_update(zstat,exp.gyro_store.get(2,i-1),i);
+        i++;
+        //stop as soon as every cell has converged for all components
+        if(grid.evaluate(stat,i)==0) break;
+    }
+    printf("recursion stopped after (i=%d) runs\n",i);
+    grid.print_results(ref);
+    printf("#END OF OPERATING POINT SWEEP...\n");
+
+    return 0;
+}
+
+//*************************************************
+//joint calibration: gyroscopic and acceleration data
+//are loaded in parallel, aligned by time and all six
+//channels pass the recursion together; convergence is
+//decided on the lowest probability of all channels
+//(call with argument "joint")
+//*************************************************
+static int joint_calibration(const runconfig &cfg)
+{
+    int i,icheck[6];
+    double stat[6][4],x[6],pval[6],ref[6],min=1.1,prop_chosen=cfg.prop,fractional_chosen=cfg.fractional;
+    const char *cname[6]={"gyro x","gyro y","gyro z","acc x","acc y","acc z"};
+    recstat recstats;
+    expdata exp;
+
+    printf("#START OF JOINT TEST WITH GYROSCOPIC AND ACCELERATION DATA...\n");
+    if(load_experiment(cfg,exp,ref,true)==0) return 1;
+    for(int j=0;j<6;j++) icheck[j]=0;
+
+    i=1;
+    while(i<=exp.data_size)
+    {
+        x[0]=exp.gyro_store.get(0,i-1); x[1]=exp.gyro_store.get(1,i-1); x[2]=exp.gyro_store.get(2,i-1);
+        x[3]=exp.acc_store.get(0,i-1);  x[4]=exp.acc_store.get(1,i-1);  x[5]=exp.acc_store.get(2,i-1);
+        //one fused pass over all six channels
+        {
+            metrics_timer timer(MET_SEQ_UPDATE);
+            for(int j=0;j<6;j++) recstats.seq_update(stat[j],x[j],i);
+        }
+        metrics::add(MET_SAMPLES_UPDATED,1);
+        i++;
+        min=1.1;
+        {
+            metrics_timer timer(MET_SEQ_ACCEPT);
+            for(int j=0;j<6;j++)
+            {
+                pval[j]=recstats.seq_accept_probability(stat[j],fractional_chosen);
+                if(min>=pval[j]) min=pval[j];
+            }
+        }
+        for(int j=0;j<6;j++)
+        {
+            if(pval[j]>=prop_chosen && i>=cfg.min_runs && icheck[j]==0)
+            {
+                printf("channel(%s),converged after (i=%d) runs, %f with relative tolerance(x 10(6)): %f\n",cname[j],i,stat[j][2],1.0e6*fabs(stat[j][2]-ref[j])/ref[j]);
+                icheck[j]=1;
+            }
+        }
+        if(min>=prop_chosen && i>=cfg.min_runs) break;
+    }
+
+    printf("RESULTS**********************:\n");
+    printf("for fractional accuracy %f and acceptance probability %f the following results are obtained:\n",fractional_chosen, prop_chosen);
+    printf("Result [1]:minimum acceptance probability of all channels is: %f after (i=%d) runs\n",min,i);
+    for(int j=0;j<6;j++)
+    {
+        printf("Result [%d]:channel %s: offset %f, variance %f, static value: %f, relative tolerance( x 10(4)): %f\n",
+               j+2,cname[j],stat[j][2],stat[j][1],ref[j],1.0e4*fabs(stat[j][2]-ref[j])/ref[j]);
+    }
+    printf("END OF RESULTS************\n");
+    printf("#END OF JOINT TEST...\n");
+
+    return 0;
+}
+
+//*************************************************
+//temperature binned calibration: the experimental
+//data is fed into the bin of the given temperature
+//of a persistent offset table, bins calibrated in an
+//earlier run are not calibrated again (call with
+//arguments "tempcal <table file> [<temperature>]")
+//*************************************************
+static int temperature_calibration(const runconfig &cfg, const char *table_file, double temp)
+{
+    int b,res;
+    double x[3],offset[3];
+    tempcache cache;
+    expdata exp;
+
+    printf("#START OF TEMPERATURE BINNED CALIBRATION...\n");
+    cache.prop_chosen=cfg.prop;
+    cache.fractional_chosen=cfg.fractional;
+    cache.min_runs=cfg.min_runs;
+    if(cache.load(table_file)) printf("loaded temperature table from file: %s\n",table_file);
+    else cache.setup(-40.0,5.0,25);
+
+    b=cache.bin_index(temp);
+    if(cache.is_converged(b))
+    {
+        printf("bin %d (temperature %f) has been calibrated before, no samples needed\n",b,temp);
+    }
+    else
+    {
+        //the data files carry no temperature: all samples belong to temp
+        exp.threads=cfg.threads;
+        exp.gyro_store.set_type(cfg.storage);
+        if(exp.read_data()==0) return 1;
+        for(int i=0;i<exp.data_size;i++)
+        {
+            x[0]=exp.gyro_store.get(0,i);
+            x[1]=exp.gyro_store.get(1,i);
+            x[2]=exp.gyro_store.get(2,i);
+            if(cache.update(temp,x))
+            {
+                printf("bin %d (temperature %f) converged after (i=%d) runs\n",b,temp,i+2);
+                break;
+            }
+        }
+    }
+
+    res=cache.lookup(temp,offset);
+    printf("offsets at temperature %f (%s): %f %f %f\n",temp,
+           res==1 ? "calibrated bin" : (res==2 ? "interpolated" : "no bin calibrated"),offset[0],offset[1],offset[2]);
+    if(cache.save(table_file)==0) return 1;
+    printf("#END OF TEMPERATURE BINNED CALIBRATION...\n");
+
+    return 0;
+}
+
+//*************************************************
+//pipelined calibration: the gyroscopic data file is
+//streamed through the ingestion pipeline, the static
+//reference and the recursion are computed on the fly
+//and reading stops as soon as both are complete (call
+//with argument "pipelined")
+//*************************************************
+static int pipelined_calibration(const runconfig &cfg)
+{
+    char fname[256],fname2[256];
+    int i=1,ist=0,icheck[3]={0,0,0},iconv[3]={0,0,0};
+    bool converged=false,static_done=false;
+    double stat[3][4]={{0.0}},sum[3]={0.0,0.0,0.0},beta[3]={0.0,0.0,0.0},conv[3]={0.0,0.0,0.0},pval[3]={0.0,0.0,0.0};
+    double tref[3],total[2]={0.0,0.0},min=1.1,static_time=cfg.static_time,prop_chosen=cfg.prop,fractional_chosen=cfg.fractional;
+    uint64_t t0;
+    recstat recstats;
+    pipeline pipe;
+
+    printf("#START OF PIPELINED TEST WITH EXPERIMENTAL DATA...\n");
+    expdata::read_names(fname,fname2);
+    pipe.format=cfg.input;
+    t0=metrics::now();
+    int res=pipe.run(fname2,[&](const expdata::dynamic *s, int n) -> bool
+    {
+        for(int k=0;k<n;k++)
+        {
+            double x[3]={s[k].x,s[k].y,s[k].z};
+            //static reference: mean over the initial static period
+            if(!static_done)
+            {
+                if(s[k].t<=static_time)
+                {
+                    ist++;
+                    for(int j=0;j<3;j++) recstats.mean(sum[j],x[j],ist);
+                }
+                else static_done=true;
+            }
+            if(converged) { if(static_done) return false; continue; }
+            for(int j=0;j<3;j++) recstats.seq_update(stat[j],x[j],i);
+            i++;
+            min=1.1;
+            for(int j=0;j<3;j++)
+            {
+                pval[j]=recstats.seq_accept_probability(stat[j],fractional_chosen);
+                if(min>=pval[j]) min=pval[j];
+                beta[j]=stat[j][2];
+                //the reference is not known yet: keep the value for the report
+                if(pval[j]>=prop_chosen && i>=cfg.min_runs && icheck[j]==0)
+                {
+                    iconv[j]=i;
+                    conv[j]=beta[j];
+                    icheck[j]=1;
+                }
+            }
+            if(min>=prop_chosen && i>=cfg.min_runs) converged=true;
+        }
+        return !(converged && static_done);
+    });
+    if(res==0)
+    {
+        printf(pipe.corrupt ? "corrupt compressed file: %s\n" : "could not open file: %s\n",fname2);
+        return 1;
+    }
+    double wall=1.0e-9*(metrics::now()-t0);
+    //the reference needs the whole static period, i.e. a sample behind it
+    if(pipe.samples==0 || ist==0 || !static_done)
+    {
+        printf("%s: %s\n",(pipe.samples==0) ? "no samples in file" : "static period of the file incomplete",fname2);
+        return 1;
+    }
+
+    for(int j=0;j<3;j++) tref[j]=sum[j];
+    for(int j=0;j<3;j++)
+    {
+        if(icheck[j]) printf("component(%d),converged after (i=%d) runs, %f with relative tolerance(x 10(6)): %f\n",j+1,iconv[j],conv[j],1.0e6*fabs((conv[j]-tref[j]))/tref[j]);
+        else printf("component(%d),not converged, %f with relative tolerance(x 10(6)): %f\n",j+1,beta[j],1.0e6*fabs((beta[j]-tref[j]))/tref[j]);
+    }
+    printf("RESULTS**********************:\n");
+    printf("for fractional accuracy %f and acceptance probability %f the following results are obtained:\n",fractional_chosen, prop_chosen);
+    printf("Result [1]:minimum acceptance probability of all components is: %f\n",min);
+    for(int j=0;j<3;j++)
+    {
+        total[0]+=tref[j];
+        total[1]+=beta[j];
+        printf("Result [%d]:component: %f, true value: %f, relative tolerance( x 10(4)): %f\n",(j+2),beta[j],tref[j],1.0e4*fabs((beta[j]-tref[j])/tref[j]));
+    }
+    printf("Result [5]:average relative accuracy achieved( x 10(4)): %f\n",1.0e4*(fabs(total[0]-total[1])/total[0]));
+    printf("Result [6]:samples read %ld (static period %d), busy time read %f s, parse %f s, statistics %f s, wall time %f s\n",
+           pipe.samples,ist,pipe.busy_read,pipe.busy_parse,pipe.busy_consume,wall);
+    printf("END OF RESULTS************\n");
+    printf("#END OF PIPELINED TEST...\n");
+
+    return 0;
+}
+
+//*************************************************
+//compression of a recording: the text file is
+//compressed by rgcodec, decoded again and compared
+//bit by bit (call with arguments "compress <text
+//file> <compressed file>")
+//*************************************************
+static int compress_recording(const runconfig &cfg, const char *in_file, const char *out_file)
+{
+    samplestore store,back;
+    rgcodec codec;
+    long text_bytes,bytes;
+    size_t bad=0;
+    uint64_t t0;
+    double seconds;
+    FILE *fp;
+
+    printf("#START OF COMPRESSION...\n");
+    int res=expdata::read_file(in_file,store,cfg.threads);
+    if(res<0)
+    {
+        printf("%s: %s\n",expdata::read_error(res),in_file);
+        return 1;
+    }
+    fp=fopen(in_file,"rb");
+    fseek(fp,0,SEEK_END);
+    text_bytes=ftell(fp);
+    fclose(fp);
+
+    bytes=codec.write_file(out_file,store);
+    if(bytes<0)
+    {
+        printf("could not write file: %s\n",out_file);
+        return 1;
+    }
+    t0=metrics::now();
+    rgcodec::read_file(out_file,back);
+    seconds=1.0e-9*(metrics::now()-t0);
+
+    //lossless: every column must be reproduced bit by bit
+    if(back.size()!=store.size()) bad=store.size();
+    else
+    {
+        vector<double> a(store.size()),b(store.size());
+        if(memcmp(store.times(),back.times(),store.size()*sizeof(double))!=0) bad++;
+        for(int j=0;j<3;j++)
+        {
+            store.copy_axis(j,0,store.size(),a.data());
+            back.copy_axis(j,0,back.size(),b.data());
+            if(memcmp(a.data(),b.data(),a.size()*sizeof(double))!=0) bad++;
+        }
+    }
+    printf("compressed %lu samples from %ld to %ld bytes (ratio %f)\n",(unsigned long) store.size(),text_bytes,bytes,(double) text_bytes/(double) bytes);
+    printf("decoded %f MB of samples per second, verification: %s\n",
+           1.0e-6*(double) back.memory()/seconds,(bad==0) ? "identical" : "FAILED");
+    printf("#END OF COMPRESSION...\n");
+
+    return (bad==0) ? 0 : 1;
+}
+
+//*************************************************
+//fleet calibration: a synthetic fleet of devices with
+//different offsets and noise levels delivers one sample
+//per device and tick while the host can only afford
+//updates for half of them; the prioritizing scheduler
+//is compared with processing in device order (call
+//with arguments "fleet [<number of devices>]")
+//*************************************************
+static int fleet_calibration(const runconfig &cfg, int ndev)
+{
+    const double dt=0.01;     //sampling interval of the devices
+    const int max_ticks=20000;
+    vector<double> mu(3*(size_t) ndev),sigma(ndev);
+    double x[3];
+    ranbase randy;
+    fleet devices;
+    int tick;
+
+    printf("#START OF FLEET CALIBRATION WITH SYNTHETIC DATA...\n");
+    setup_random(cfg,randy,1);
+    for(int d=0;d<ndev;d++)
+    {
+        for(int j=0;j<3;j++) mu[3*(size_t) d+j]=32000.0+500.0*randy.ran_gauss();
+        sigma[d]=50.0+950.0*randy.ran_short();
+    }
+    printf("%d devices, host budget %d updates per tick (%d samples arrive per tick)\n",ndev,ndev/2,ndev);
+
+    for(int run=0;run<2;run++)
+    {
+        setup_random(cfg,randy,2);
+        devices.prioritize=(run==0);
+        devices.prop_chosen=cfg.prop;
+        devices.fractional_chosen=cfg.fractional;
+        devices.min_runs=cfg.min_runs;
+        devices.setup(ndev);
+        for(tick=1;tick<=max_ticks && devices.converged<ndev;tick++)
+        {
+            //every device delivers a sample per tick (the same streams in both runs)
+            for(int d=0;d<ndev;d++)
+            {
+                for(int j=0;j<3;j++) x[j]=mu[3*(size_t) d+j]+sigma[d]*randy.ran_gauss();
+                devices.push(d,x,tick*dt);
+            }
+            devices.schedule(ndev/2,tick*dt);
+        }
+        printf("%s: %d of %d devices converged after %d ticks, %ld updates, %ld samples shed\n",
+               devices.prioritize ? "prioritized" : "device order",devices.converged,ndev,tick-1,devices.updates,devices.shed);
+        printf("  latency to convergence (s): p50 %f, p90 %f, p99 %f, max %f\n",devices.latency_percentile(0.5),
+               devices.latency_percentile(0.9),devices.latency_percentile(0.99),devices.latency_percentile(1.0));
+    }
+    printf("#END OF FLEET CALIBRATION...\n");
+
+    return 0;
+}
+
+//*************************************************
+//offset plus drift: a synthetic gyroscope whose bias
+//ramps linearly and the experimental data given in
+//"dnames" are calibrated with the constant-offset
+//recursion (recstat) and with the offset+drift fit
+//(recdrift), the samples to convergence and the
+//errors of the offsets are compared (call with
+//argument "drift")
+//*************************************************
+static int drift_run(const char *name, const samplestore &store, int nmax, double prop_chosen, double fractional_chosen,
+                     int min_runs, const double bias[], const double rate[])
+{
+    double stat[3][4],pval[3],min,conv[2][3],tconv[2]={0.0,0.0},ref;
+    int iconv[2][3]={{0,0,0},{0,0,0}},i;
+    expdata::dynamic s;
+    recstat recstats;
+    recdrift fit;
+
+    for(int model=0;model<2;model++)
+    {
+        for(int j=0;j<3;j++) for(int k=0;k<4;k++) stat[j][k]=0.0;
+        fit.reset();
+        for(i=1;i<=nmax;)
+        {
+            s.t=store.time(i-1); s.x=store.get(0,i-1); s.y=store.get(1,i-1); s.z=store.get(2,i-1);
+            if(model==0) {recstats.seq_update(stat[0],s.x,i); recstats.seq_update(stat[1],s.y,i); recstats.seq_update(stat[2],s.z,i);}
+            else fit.update(s);
+            i++;
+            min=1.1;
+            for(int j=0;j<3;j++)
+            {
+                pval[j]=(model==0) ? recstats.seq_accept_probability(stat[j],fractional_chosen) : fit.accept_probability(j,fractional_chosen);
+                if(min>=pval[j]) min=pval[j];
+                if(pval[j]>=prop_chosen && i>=min_runs && iconv[model][j]==0) iconv[model][j]=i;
+            }
+            if(min>=prop_chosen && i>=min_runs) break;
+        }
+        for(int j=0;j<3;j++) conv[model][j]=(model==0) ? stat[j][2] : fit.estimate(j);
+        tconv[model]=s.t;
+    }
+
+    //both estimates against the bias at the end of their window, the current bias
+    //(for the experimental data the static reference, rate is NULL)
+    printf("%s (%d samples):\n",name,nmax);
+    for(int j=0;j<3;j++)
+    {
+        for(int model=0;model<2;model++)
+        {
+            ref=(rate!=NULL) ? bias[j]+rate[j]*(tconv[model]-store.time(0)) : bias[j];
+            if(iconv[model][j]==0) printf("component(%d),%s model not converged, %f",j+1,model==0 ? "constant" : "drift",conv[model][j]);
+            else printf("component(%d),%s model converged after (i=%d) runs, %f",j+1,model==0 ? "constant" : "drift",iconv[model][j],conv[model][j]);
+            printf(" with relative tolerance(x 10(6)): %f",1.0e6*fabs(conv[model][j]-ref)/ref);
+            if(model==1 && fit.drift_used(j)) printf(", drift %f per s",fit.drift(j));
+            else if(model==1) printf(", drift not used (%f per s)",fit.drift(j));
+            if(model==1 && rate!=NULL) printf(" (true value %f)",rate[j]);
+            printf("\n");
+        }
+    }
+    printf("end of calibration at t=%f s (constant model) and t=%f s (drift model)\n",tconv[0]-store.time(0),tconv[1]-store.time(0));
+    return 0;
+}
+
+static int drift_calibration(const runconfig &cfg)
+{
+    const double dt=0.01,sigma=987.34;
+    const double bias[3]={32777.15,32459.82,32511.85},rate[3]={4.0,-2.5,1.0};
+    const int nsynth=100000;
+    //the operating point of this comparison unless it is set
+    double ref[3],prop_chosen=cfg.prop,fractional_chosen=cfg.is_set("fractional") ? cfg.fractional : 0.0005;
+    ranbase randy;
+    samplestore synth;
+    expdata exp;
+
+    printf("#START OF OFFSET AND DRIFT CALIBRATION...\n");
+    setup_random(cfg,randy,1);
+    synth.resize(nsynth);
+    for(int k=0;k<nsynth;k++)
+    {
+        double t=k*dt,x[3];
+        for(int j=0;j<3;j++) x[j]=bias[j]+rate[j]*t+sigma*randy.ran_gauss();
+        synth.set(k,t,x[0],x[1],x[2]);
+    }
+    drift_run("synthetic drifting gyroscope",synth,nsynth,prop_chosen,fractional_chosen,cfg.min_runs,bias,rate);
+
+    if(load_experiment(cfg,exp,ref)==0) return 1;
+    drift_run("experimental data",exp.gyro_store,exp.data_size,prop_chosen,fractional_chosen,cfg.min_runs,ref,NULL);
+    printf("#END OF OFFSET AND DRIFT CALIBRATION...\n");
+
+    return 0;
+}
+
+//*************************************************
+//bootstrap confidence intervals: the static segment
+//of the experimental data given in "dnames" is
+//resampled by the moving block bootstrap (class
+//bootstrap), percentile intervals of the static
+//offset and of the recursive estimate at convergence
+//are reported and the erf-based acceptance
+//probability of the recursion is compared with the
+//bootstrap fraction within the fractional accuracy
+//(call with argument "bootstrap [<replicates>]")
+//*************************************************
+static int bootstrap_calibration(const runconfig &cfg, int replicates)
+{
+    const double level=0.95;
+    const double fgrid[5]={0.00005,0.0001,0.0002,0.001,0.005};
+    double stat[3][4],off[3],lo,hi,min,seconds1,prop_chosen=cfg.prop,fractional_chosen=cfg.fractional;
+    int i,m=0,same=1;
+    recstat recstats;
+    expdata exp;
+    bootstrap boot;
+    vector<double> serial[3][2];
+
+    printf("#START OF BOOTSTRAP CONFIDENCE INTERVALS...\n");
+    if(load_experiment(cfg,exp,off)==0) return 1;
+
+    //samples of the recursion to convergence on the experimental data
+    for(int j=0;j<3;j++) for(int k=0;k<4;k++) stat[j][k]=0.0;
+    for(i=1;i<=exp.data_size;i++)
+    {
+        for(int j=0;j<3;j++) recstats.seq_update(stat[j],exp.gyro_store.get(j,i-1),i);
+        m=i;
+        min=1.1;
+        for(int j=0;j<3;j++) if(min>=recstats.seq_accept_probability(stat[j],fractional_chosen)) min=recstats.seq_accept_probability(stat[j],fractional_chosen);
+        if(min>=prop_chosen && i+1>=cfg.min_runs) break;
+    }
+
+    if(boot.setup(exp.gyro_store,exp.static_int+1)==0) return 1;
+    boot.replicates=replicates;
+    boot.seed=cfg.seed;
+    //one thread as reference: the replicates do not depend on the number of threads
+    boot.threads=1;
+    boot.run(m);
+    seconds1=boot.seconds;
+    for(int j=0;j<3;j++) {serial[j][0]=boot.mean_rep[j]; serial[j][1]=boot.rec_rep[j];}
+    boot.threads=cfg.threads;
+    boot.run(m);
+    for(int j=0;j<3;j++) if(serial[j][0]!=boot.mean_rep[j] || serial[j][1]!=boot.rec_rep[j]) same=0;
+
+    printf("%d replicates of %d static samples in blocks of %d, recursion converged after %d samples\n",
+           replicates,boot.size(),boot.block_length(),m);
+    for(int j=0;j<3;j++)
+    {
+        bootstrap::interval(boot.mean_rep[j],level,lo,hi);
+        printf("component(%d), static offset %f, %.0f%% interval [%f,%f]",j+1,off[j],100.0*level,lo,hi);
+        bootstrap::interval(boot.rec_rep[j],level,lo,hi);
+        printf(", recursive estimate %f, %.0f%% interval [%f,%f]\n",stat[j][2],100.0*level,lo,hi);
+    }
+    printf("acceptance probability after %d samples, erf (recursion) vs. bootstrap:\n",m);
+    for(int k=0;k<5;k++)
+    {
+        printf("f=%g",fgrid[k]);
+        for(int j=0;j<3;j++)
+            printf(", component(%d) %f vs. %f",j+1,recstats.seq_accept_probability(stat[j],fgrid[k]),
+                   bootstrap::coverage(boot.rec_rep[j],off[j],fgrid[k]));
+        printf("\n");
+    }
+    printf("time %f s on 1 thread, %f s on all threads, replicates %s\n",seconds1,boot.seconds,same ? "identical" : "DIFFERENT");
+    printf("#END OF BOOTSTRAP CONFIDENCE INTERVALS...\n");
+
+    return same ? 0 : 1;
+}
+
+//*************************************************
+//irregular time stamps: the experimental data given
+//in "dnames" and a copy with dropped packets,
+//repeated samples and bursts are calibrated with the
+//recursion over the samples as they arrive (recstat)
+//and with the time-weighted recursion (rectime) which
+//detects gaps and duplicates from the time stamps;
+//convergence decisions made across a gap are flagged
+//(call with argument "irregular")
+//*************************************************
+static void irregular_run(const char *name, const samplestore &store, int nmax, double prop_chosen, double fractional_chosen,
+                          int min_runs, const double ref[])
+{
+    double stat[3][4],pval[3],min,conv[2][3];
+    int iconv[2][3]={{0,0,0},{0,0,0}},i;
+    expdata::dynamic s;
+    recstat recstats;
+    rectime fit;
+
+    for(int model=0;model<2;model++)
+    {
+        for(int j=0;j<3;j++) for(int k=0;k<4;k++) stat[j][k]=0.0;
+        fit.reset();
+        for(i=1;i<=nmax;i++)
+        {
+            s.t=store.time(i-1); s.x=store.get(0,i-1); s.y=store.get(1,i-1); s.z=store.get(2,i-1);
+            if(model==0) {recstats.seq_update(stat[0],s.x,i); recstats.seq_update(stat[1],s.y,i); recstats.seq_update(stat[2],s.z,i);}
+            else if(fit.update(s)==RECTIME_DUPLICATE) continue;
+            min=1.1;
+            for(int j=0;j<3;j++)
+            {
+                pval[j]=(model==0) ? recstats.seq_accept_probability(stat[j],fractional_chosen) : fit.accept_probability(j,fractional_chosen);
+                if(min>=pval[j]) min=pval[j];
+            }
+            //minimum of runs as in main: counted in samples which entered the recursion
+            if(((model==0) ? i : (int) fit.samples())+1<min_runs) continue;
+            for(int j=0;j<3;j++) if(pval[j]>=prop_chosen && iconv[model][j]==0) iconv[model][j]=i;
+            if(min>=prop_chosen) break;
+        }
+        for(int j=0;j<3;j++) conv[model][j]=(model==0) ? stat[j][2] : fit.offset(j);
+    }
+
+    printf("%s (%d samples):\n",name,nmax);
+    for(int j=0;j<3;j++)
+    {
+        for(int model=0;model<2;model++)
+        {
+            if(iconv[model][j]==0) printf("component(%d),%s not converged, %f",j+1,model==0 ? "per sample" : "time-weighted",conv[model][j]);
+            else printf("component(%d),%s converged after (i=%d) samples, %f",j+1,model==0 ? "per sample" : "time-weighted",iconv[model][j],conv[model][j]);
+            printf(" with relative tolerance(x 10(6)): %f\n",1.0e6*fabs(conv[model][j]-ref[j])/ref[j]);
+        }
+    }
+    printf("nominal interval %f s, %ld duplicates ignored, %ld gaps (%f s missing)%s\n",fit.interval(),(long) fit.duplicates(),
+           (long) fit.gaps(),fit.gap_time(),fit.across_gap() ? ", time-weighted decision made ACROSS GAPS" : "");
+}
+
+static int irregular_calibration(const runconfig &cfg)
+{
+    //the operating point of this comparison unless it is set
+    double ref[3],u,prop_chosen=cfg.prop,fractional_chosen=cfg.is_set("fractional") ? cfg.fractional : 0.0002;
+    int n=0,ndrop=0,ndup=0,nburst=0;
+    ranbase randy;
+    samplestore field;
+    expdata exp;
+
+    printf("#START OF CALIBRATION ON IRREGULAR TIME STAMPS...\n");
+    if(load_experiment(cfg,exp,ref)==0) return 1;
+    irregular_run("experimental data",exp.gyro_store,exp.data_size,prop_chosen,fractional_chosen,cfg.min_runs,ref);
+
+    //field log: runs of up to 30 dropped packets, samples repeated up to three times
+    //and bursts of 8 samples received at once after a delay (time stamped on reception)
+    setup_random(cfg,randy,2,false);
+    field.resize(2*exp.data_size);
+    for(int i=0;i<exp.data_size;)
+    {
+        const samplestore &g=exp.gyro_store;
+        u=randy.ran_long();
+        if(u<0.01)
+        {
+            i+=1+(int) (30.0*randy.ran_long());
+            ndrop++;
+        }
+        else if(u<0.03)
+        {
+            int copies=2+(int) (3.0*randy.ran_long());
+            for(int c=0;c<copies;c++,n++) field.set(n,g.time(i),g.get(0,i),g.get(1,i),g.get(2,i));
+            i++;
+            ndup++;
+        }
+        else if(u<0.04 && i+8<exp.data_size)
+        {
+            double dt=g.time(i+1)-g.time(i);
+            for(int k=0;k<8;k++,n++) field.set(n,g.time(i+7)+0.2*(k-7)*dt,g.get(0,i+k),g.get(1,i+k),g.get(2,i+k));
+            i+=8;
+            nburst++;
+        }
+        else
+        {
+            field.set(n++,g.time(i),g.get(0,i),g.get(1,i),g.get(2,i));
+            i++;
+        }
+    }
+    printf("field log: %d drop runs, %d repeated samples, %d bursts injected\n",ndrop,ndup,nburst);
+    irregular_run("field log",field,n,prop_chosen,fractional_chosen,cfg.min_runs,ref);
+    printf("#END OF CALIBRATION ON IRREGULAR TIME STAMPS...\n");
+
+    return 0;
+}
+
+//*************************************************
+//spiky data: bus glitches (single samples displaced
+//by 20 to 60 standard deviations, two of them within
+//the first samples) are injected into the experimental
+//data given in "dnames", which is then calibrated with
+//seq_update and with seq_update_robust (gate c); the
+//samples to convergence and the errors of the offsets
+//are compared with the clean data (call with
+//arguments "spikes [<c>]")
+//*************************************************
+static void spike_run(const char *name, const samplestore &store, int nmax, double prop_chosen, double fractional_chosen,
+                      int min_runs, double c, const double ref[])
+{
+    double stat[3][RECSTAT_ROBUST_SIZE]={{0.0}},pval[3],min=1.1;
+    int iconv[3]={0,0,0},i;
+    recstat recstats;
+
+    for(i=1;i<=nmax;)
+    {
+        for(int j=0;j<3;j++)
+        {
+            if(c>0.0) recstats.seq_update_robust(stat[j],store.get(j,i-1),c);
+            else recstats.seq_update(stat[j],store.get(j,i-1),i);
+        }
+        i++;
+        //no probability before the warm-up of the gate is complete
+        if(c>0.0 && !recstat::robust_seeded(stat[0])) continue;
+        min=1.1;
+        for(int j=0;j<3;j++)
+        {
+            pval[j]=recstats.seq_accept_probability(stat[j],fractional_chosen);
+            if(min>=pval[j]) min=pval[j];
+            if(pval[j]>=prop_chosen && i>=min_runs && iconv[j]==0) iconv[j]=i;
+        }
+        if(min>=prop_chosen && i>=min_runs) break;
+    }
+    printf("%s:\n",name);
+    for(int j=0;j<3;j++)
+    {
+        if(iconv[j]==0) printf("component(%d),not converged, %f",j+1,stat[j][2]);
+        else printf("component(%d),converged after (i=%d) runs, %f",j+1,iconv[j],stat[j][2]);
+        printf(" with relative tolerance(x 10(6)): %f",1.0e6*fabs(stat[j][2]-ref[j])/ref[j]);
+        if(c>0.0) printf(", %d samples rejected",(int) stat[j][RECSTAT_ROBUST_REJECTED]);
+        printf("\n");
+    }
+}
+
+static int spike_calibration(const runconfig &cfg, double c)
+{
+    //the operating point of this comparison unless it is set
+    double ref[3],sigma[3],stat[4],prop_chosen=cfg.prop,fractional_chosen=cfg.is_set("fractional") ? cfg.fractional : 0.0002;
+    int nspike=0;
+    ranbase randy;
+    samplestore spiky;
+    expdata exp;
+
+    printf("#START OF CALIBRATION ON SPIKY DATA...\n");
+    if(load_experiment(cfg,exp,ref)==0) return 1;
+
+    //noise level of each component from the static period
+    recstat recstats;
+    for(int j=0;j<3;j++)
+    {
+        for(int i=1;i<=exp.static_int+1;i++) recstats.seq_update(stat,exp.gyro_store.get(j,i-1),i);
+        sigma[j]=sqrt(stat[1]);
+    }
+
+    //glitches: 0.5% of the samples, and the 3rd and 10th sample (within the warm-up)
+    setup_random(cfg,randy,2,false);
+    spiky.resize(exp.data_size);
+    for(int i=0;i<exp.data_size;i++)
+    {
+        double x[3];
+        bool glitch=(randy.ran_long()<0.005 || i==2 || i==9);
+        for(int j=0;j<3;j++)
+        {
+            x[j]=exp.gyro_store.get(j,i);
+            if(glitch) x[j]+=((randy.ran_long()<0.5) ? -1.0 : 1.0)*(20.0+40.0*randy.ran_long())*sigma[j];
+        }
+        if(glitch) nspike++;
+        spiky.set(i,exp.gyro_store.time(i),x[0],x[1],x[2]);
+    }
+    printf("noise levels %f %f %f, %d glitches injected into %d samples, gate %f standard deviations\n",sigma[0],sigma[1],sigma[2],
+           nspike,exp.data_size,c);
+    spike_run("clean data, seq_update",exp.gyro_store,exp.data_size,prop_chosen,fractional_chosen,cfg.min_runs,0.0,ref);
+    spike_run("spiky data, seq_update",spiky,exp.data_size,prop_chosen,fractional_chosen,cfg.min_runs,0.0,ref);
+    spike_run("spiky data, seq_update_robust",spiky,exp.data_size,prop_chosen,fractional_chosen,cfg.min_runs,c,ref);
+    printf("#END OF CALIBRATION ON SPIKY DATA...\n");
+
+    return 0;
+}
+
+//*************************************************
+//per-channel convergence: the components of the
+//experimental data given in "dnames" and a synthetic
+//set of channels with widely spread noise levels are
+//calibrated with the multi-channel recursion, once
+//with early retirement of converged channels and
+//once updating all channels until the last one
+//converged as in main; updates, time and the
+//frozen offsets are compared (call with argument
+//"channels [<synthetic channels>]")
+//*************************************************
+static int channel_calibration(const runconfig &cfg, int nchan)
+{
+    //fractional accuracy of the experimental part (0.0002 unless it is set) and of the synthetic channels
+    const double fexp=cfg.is_set("fractional") ? cfg.fractional : 0.0002,fsyn=cfg.fractional,bias=32500.0;
+    double x[3],ref[3],t[3];
+    long upd[3];
+    int same=1,nsteps=0;
+    multichan mc[3];
+    ranbase randy;
+    expdata exp;
+    vector<double> sigma,xs;
+
+    printf("#START OF PER-CHANNEL CALIBRATION...\n");
+    if(load_experiment(cfg,exp,ref)==0) return 1;
+
+    //the components of the experimental data at fractional accuracy fexp
+    for(int r=0;r<2;r++)
+    {
+        mc[r].prop_chosen=cfg.prop;
+        mc[r].fractional_chosen=fexp;
+        mc[r].min_runs=cfg.min_runs;
+        mc[r].retire=(r==0);
+        mc[r].setup(3);
+        for(int i=0;i<exp.data_size;i++)
+        {
+            for(int j=0;j<3;j++) x[j]=exp.gyro_store.get(j,i);
+            if(mc[r].update(x)==0) break;
+        }
+    }
+    printf("experimental data at fractional accuracy %g:\n",fexp);
+    for(int j=0;j<3;j++)
+    {
+        printf("component(%d),converged after (i=%d) runs, frozen %f with relative tolerance(x 10(6)): %f",j+1,mc[0].iconv[j]+1,
+               mc[0].offset[j],1.0e6*fabs(mc[0].offset[j]-ref[j])/ref[j]);
+        printf(", updated until the last converged %f with relative tolerance(x 10(6)): %f\n",mc[1].estimate(j),
+               1.0e6*fabs(mc[1].estimate(j)-ref[j])/ref[j]);
+    }
+    printf("channel updates: %ld with retirement, %ld without\n",mc[0].updates,mc[1].updates);
+
+    //synthetic channels: noise levels spread over a factor of 20, i.e. samples
+    //to convergence over a factor of about 400
+    setup_random(cfg,randy,2,false);
+    sigma.resize(nchan);
+    xs.resize(nchan);
+    for(int c=0;c<nchan;c++) sigma[c]=200.0*pow(20.0,randy.ran_long());
+    for(int r=0;r<3;r++)
+    {
+        mc[r].retire=(r!=1);
+        mc[r].recheck=(r==2) ? 64 : 0;
+        mc[r].fractional_chosen=fsyn;
+        mc[r].setup(nchan);
+        t[r]=0.0;
+    }
+    //the same samples for the three runs, only the updates are timed
+    for(int open=nchan;open>0;nsteps++)
+    {
+        for(int c=0;c<nchan;c++) xs[c]=bias+sigma[c]*randy.ran_gauss();
+        open=0;
+        for(int r=0;r<3;r++)
+        {
+            uint64_t t0=metrics::now();
+            int o=(mc[r].active()>0 || r==1) ? mc[r].update(xs.data()) : 0;
+            t[r]+=1.0e-9*(metrics::now()-t0);
+            if(r!=2 && o>open) open=o;
+        }
+    }
+    for(int r=0;r<3;r++) upd[r]=mc[r].updates;
+    for(int c=0;c<nchan;c++) if(mc[0].iconv[c]!=mc[1].iconv[c] || mc[0].offset[c]!=mc[1].offset[c]) same=0;
+    printf("%d synthetic channels, %d samples until the last converged:\n",nchan,nsteps);
+    printf("all channels until the last converged: %ld updates, %f s\n",upd[1],t[1]);
+    printf("early retirement:                      %ld updates, %f s (%.1f times faster), frozen offsets %s\n",upd[0],t[0],
+           t[1]/t[0],same ? "identical" : "DIFFERENT");
+    printf("early retirement, recheck every 64:    %ld updates, %f s, %ld offsets revised\n",upd[2],t[2],mc[2].revised);
+    printf("#END OF PER-CHANNEL CALIBRATION...\n");
+
+    return same ? 0 : 1;
+}
+
+//*************************************************
+//scripted runs: the experimental data (file from
+//"--gyro" or "dnames") is calibrated by the engine
+//selected with "--engine" (scalar: the loop of main,
+//batched: multichan with early retirement,
+//streaming: the calibrator of librecgyro) at the
+//operating point of the configuration; "--repeat n"
+//times n runs on the loaded data and "--output"
+//selects text, csv or json (call with argument
+//"run")
+//*************************************************
+static void on_axis_converged(void *user, int axis, int64_t n, double offset, double prob)
+{
+    (void) offset;
+    (void) prob;
+    ((int *) user)[axis]=(int) n+1;
+}
+
+//one calibration by the engine of cfg: returns the samples used, iconv[j] is the
+//run counter at the convergence of component j (0: not converged)
+static int run_engine(const runconfig &cfg, const samplestore &store, int n, int iconv[], double off[])
+{
+    int used=0;
+
+    for(int j=0;j<3;j++) iconv[j]=0;
+    if(cfg.engine==RUNCONFIG_ENGINE_SCALAR)
+    {
+        double stat[3][4]={{0.0}},pval[3],min=1.1;
+        recstat recstats;
+        for(int i=1;i<=n;)
+        {
+            for(int j=0;j<3;j++) recstats.seq_update(stat[j],store.get(j,i-1),i);
+            used=i;
+            i++;
+            min=1.1;
+            for(int j=0;j<3;j++)
+            {
+                pval[j]=recstats.seq_accept_probability(stat[j],cfg.fractional);
+                if(min>=pval[j]) min=pval[j];
+                if(pval[j]>=cfg.prop && i>=cfg.min_runs && iconv[j]==0) iconv[j]=i;
+            }
+            if(min>=cfg.prop && i>=cfg.min_runs) break;
+        }
+        for(int j=0;j<3;j++) off[j]=stat[j][2];
+    }
+    else if(cfg.engine==RUNCONFIG_ENGINE_BATCHED)
+    {
+        multichan mc;
+        double x[3];
+        mc.prop_chosen=cfg.prop;
+        mc.fractional_chosen=cfg.fractional;
+        mc.min_runs=cfg.min_runs;
+        mc.setup(3);
+        while(used<n)
+        {
+            for(int j=0;j<3;j++) x[j]=store.get(j,used);
+            used++;
+            if(mc.update(x)==0) break;
+        }
+        for(int j=0;j<3;j++)
+        {
+            iconv[j]=(mc.iconv[j]>0) ? mc.iconv[j]+1 : 0;
+            off[j]=(mc.iconv[j]>0) ? mc.offset[j] : mc.estimate(j);
+        }
+    }
+    else
+    {
+        calibrator cal;
+        recgyro_config c;
+        double x[3];
+        recgyro_default_config(&c);
+        c.prop=cfg.prop;
+        c.fractional=cfg.fractional;
+        c.min_runs=cfg.min_runs;
+        cal.configure(c);
+        cal.set_callbacks(on_axis_converged,nullptr,iconv);
+        while(used<n)
+        {
+            for(int j=0;j<3;j++) x[j]=store.get(j,used);
+            used++;
+            if(cal.push(x)==RECGYRO_CONVERGED) break;
+        }
+        cal.offsets(off,nullptr);
+    }
+    return used;
+}
+
+static int run_calibration(const runconfig &cfg)
+{
+    char fname[150],fname2[150];
+    double ref[3],off[3],sec_min,sec_med,sec_mean=0.0;
+    int iconv[3],used=0;
+    vector<double> seconds;
+    expdata exp;
+
+    //silent loading such that csv and json stay parseable
+    expdata::read_names(fname,fname2);
+    if(load_experiment(cfg,exp,ref,false,false)==0) return 1;
+
+    for(int r=0;r<cfg.repeat;r++)
+    {
+        uint64_t t0=metrics::now();
+        used=run_engine(cfg,exp.gyro_store,exp.data_size,iconv,off);
+        seconds.push_back(1.0e-9*(metrics::now()-t0));
+        sec_mean+=seconds.back()/cfg.repeat;
+    }
+    sort(seconds.begin(),seconds.end());
+    sec_min=seconds.front();
+    sec_med=seconds[seconds.size()/2];
+
+    if(cfg.output==RUNCONFIG_OUTPUT_CSV)
+    {
+        printf("engine,file,component,converged_after,offset,reference,tolerance_ppm,samples,runs,seconds_min,seconds_median,samples_per_s\n");
+        for(int j=0;j<3;j++)
+            printf("%s,%s,%d,%d,%.6f,%.6f,%.6f,%d,%d,%.9f,%.9f,%.0f\n",cfg.engine_name(),fname2,j+1,iconv[j],off[j],ref[j],
+                   1.0e6*fabs(off[j]-ref[j])/ref[j],used,cfg.repeat,sec_min,sec_med,used/sec_min);
+    }
+    else if(cfg.output==RUNCONFIG_OUTPUT_JSON)
+    {
+        printf("{\"engine\":\"%s\",\"file\":\"%s\",\"prop\":%g,\"fractional\":%g,\"static_time\":%g,\"min_runs\":%d,\"samples\":%d,\"components\":[",
+               cfg.engine_name(),fname2,cfg.prop,cfg.fractional,cfg.static_time,cfg.min_runs,used);
+        for(int j=0;j<3;j++)
+            printf("%s{\"converged_after\":%d,\"offset\":%.6f,\"reference\":%.6f,\"tolerance_ppm\":%.6f}",(j>0) ? "," : "",iconv[j],off[j],ref[j],
+                   1.0e6*fabs(off[j]-ref[j])/ref[j]);
+        printf("],\"timing\":{\"runs\":%d,\"seconds_min\":%.9f,\"seconds_median\":%.9f,\"seconds_mean\":%.9f,\"samples_per_s\":%.0f}}\n",
+               cfg.repeat,sec_min,sec_med,sec_mean,used/sec_min);
+    }
+    else
+    {
+        printf("engine %s on %s for fractional accuracy %f and acceptance probability %f:\n",cfg.engine_name(),fname2,cfg.fractional,cfg.prop);
+        for(int j=0;j<3;j++)
+        {
+            if(iconv[j]==0) printf("component(%d),not converged, %f",j+1,off[j]);
+            else printf("component(%d),converged after (i=%d) runs, %f",j+1,iconv[j],off[j]);
+            printf(" with relative tolerance(x 10(6)): %f\n",1.0e6*fabs(off[j]-ref[j])/ref[j]);
+        }
+        printf("%d samples, time per run over %d runs: min %f s, median %f s, mean %f s, %.0f samples/s\n",used,cfg.repeat,sec_min,sec_med,
+               sec_mean,used/sec_min);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
 {
     int i;
     int icheck[3];
@@ -40,6 +1090,82 @@ int main()
     ranbase randy;
     recstat recstats;
     expdata exp;
+    tracer trace;
+    bool tracing=false;
+    int kmode=0,nmin,nmax;
+    runconfig cfg;
+
+    //command line: "sweep" selects the operating point sweep, "joint" the joint
+    //calibration of gyroscope and accelerometer, "tempcal <file> [<temp>]" the
+    //temperature binned calibration, "pipelined" the calibration with pipelined
+    //ingestion of the experimental data, "compress <text file> <compressed file>"
+    //the lossless compression of a recording, "fleet [<devices>]" the scheduled
+    //calibration of a synthetic fleet, "drift" the offset plus drift fit, "bootstrap [<replicates>]" the
+    //bootstrap confidence intervals of the offsets, "irregular" the time-weighted
+    //calibration on irregular time stamps, "channels [<channels>]" the per-channel
+    //calibration with early retirement, "spikes [<c>]" the gated recursion on
+    //data with glitches, "run" calibrates the experimental data with the engine
+    //of the configuration. without a mode the test of the publication is run.
+    //all other arguments are parameters of runconfig ("--config <file>", "--prop",
+    //"--fractional", "--static-time", "--min-runs", "--rng", "--seed", "--threads",
+    //"--gyro", "--acc", "--input", "--engine", "--output", "--repeat", "--fgrid",
+    //"--pgrid", "--storage <double|float|int32>" the type of the stored components,
+    //"--metrics <file>" timers and counters (JSON or, for *.prom, Prometheus) and
+    //for the run without a mode "--trace <file>" the full trajectory of the
+    //recursion in a binary trace file (ring buffer of "--trace-capacity <records>",
+    //"--trace-drop" drops records instead of waiting when it is full), "--robust <c>"
+    //the gate of outliers beyond c standard deviations and "--decimate <d>" the
+    //averaging of blocks of d experimental samples before they enter the recursion).
+    //they replace "dnames" and the constants of the publication, a mode rejects
+    //those it does not use (drift, irregular, spikes and channels keep their own
+    //fractional accuracy unless it is set) and unknown arguments are rejected
+    if(cfg.parse(argc,argv)==0 || cfg.apply()==0) return 1;
+    for(int k=1;k<argc;k++)
+    {
+        if(runconfig::is_option(argv[k])) {if(!runconfig::is_flag(argv[k])) k++; continue;}
+        if(kmode==0 && (nmax=mode_args(argv[k],nmin))>=0)
+        {
+            kmode=k;
+            for(int n=0;n<nmax && mode_arg(argc,argv,k+1)!=NULL;n++) k++;
+            if(k-kmode<nmin)
+            {
+                printf("missing argument of the mode %s\n",argv[kmode]);
+                return 1;
+            }
+            continue;
+        }
+        printf("unknown argument: %s\n",argv[k]);
+        return 1;
+    }
+    metrics::enabled=!cfg.metrics.empty();
+    if(kmode>0)
+    {
+        const char *mode=argv[kmode],*arg1=mode_arg(argc,argv,kmode+1);
+        int rc;
+        if(cfg.check_used(mode,mode_keys(mode))==0) return 1;
+        if(strcmp(mode,"sweep")==0) rc=sweep_operating_points(cfg);
+        else if(strcmp(mode,"joint")==0) rc=joint_calibration(cfg);
+        else if(strcmp(mode,"pipelined")==0) rc=pipelined_calibration(cfg);
+        else if(strcmp(mode,"run")==0) rc=run_calibration(cfg);
+        else if(strcmp(mode,"drift")==0) rc=drift_calibration(cfg);
+        else if(strcmp(mode,"channels")==0) rc=channel_calibration(cfg,arg1 ? atoi(arg1) : 1024);
+        else if(strcmp(mode,"irregular")==0) rc=irregular_calibration(cfg);
+        else if(strcmp(mode,"spikes")==0) rc=spike_calibration(cfg,arg1 ? atof(arg1) : 5.0);
+        else if(strcmp(mode,"bootstrap")==0) rc=bootstrap_calibration(cfg,arg1 ? atoi(arg1) : 2000);
+        else if(strcmp(mode,"fleet")==0) rc=fleet_calibration(cfg,arg1 ? atoi(arg1) : 1000);
+        else if(strcmp(mode,"compress")==0) rc=compress_recording(cfg,arg1,argv[kmode+2]);
+        else rc=temperature_calibration(cfg,arg1,mode_arg(argc,argv,kmode+2) ? atof(argv[kmode+2]) : 25.0);
+        if(metrics::enabled && metrics::dump(cfg.metrics.c_str())==0) return 1;
+        return rc;
+    }
+
+    if(cfg.check_used("default",mode_keys(NULL))==0) return 1;
+    if(!cfg.trace.empty())
+    {
+        trace.block=!cfg.trace_drop;
+        if(trace.open(cfg.trace.c_str(),(size_t) cfg.trace_capacity)==0) return 1;
+        tracing=true;
+    }
 
     //***********************************************
     //+++++++++++++++++++++++++++++++++++++++++++++++
@@ -49,15 +1175,15 @@ int main()
 
     //************************************************
     //set up and initialize the random number generator
-    randy.initialize_random_generators(1);
+    setup_random(cfg,randy,cfg.rng);
     //*************************************************
 
     //*************************************************
     //set the desired acceptance probability(=prop_chosen)
     //and the chosen fractional accuracy(=fractional_chosen)
-    //of the result
-    prop_chosen=0.9;
-    fractional_chosen=0.005;
+    //of the result (0.9 and 0.005 unless configured)
+    prop_chosen=cfg.prop;
+    fractional_chosen=cfg.fractional;
     //*************************************************
 
 
@@ -84,13 +1210,25 @@ int main()
         rd[0]=tmean[0]+tvariance[0]*randy.ran_gauss();
         rd[1]=a+randy.ran_short()*b;
         //update the statistical properties with the computed value
-        recstats.seq_update(gran,rd[0],i);
-        recstats.seq_update(uran,rd[1],i);
+        {
+            metrics_timer timer(MET_SEQ_UPDATE);
+            recstats.seq_update(gran,rd[0],i);
+            recstats.seq_update(uran,rd[1],i);
+        }
+        metrics::add(MET_SAMPLES_UPDATED,1);
         //compute the acceptance probability for each component and the lowest overall
         i++;
         min=1.1;
-        pval[0]=recstats.seq_accept_probability(gran,fractional_chosen);
-        pval[1]=recstats.seq_accept_probability(uran,fractional_chosen);
+        {
+            metrics_timer timer(MET_SEQ_ACCEPT);
+            pval[0]=recstats.seq_accept_probability(gran,fractional_chosen);
+            pval[1]=recstats.seq_accept_probability(uran,fractional_chosen);
+        }
+        if(tracing)
+        {
+            trace.record(0,0,i,gran,pval[0]);
+            trace.record(0,1,i,uran,pval[1]);
+        }
         for(int j=0;j<2;j++) { if(min>=pval[j]) min=pval[j];}  //store the lowest acceptance proability
 
         //store the mean of means for later usage
@@ -100,13 +1238,13 @@ int main()
         //for test purposes: check and store at which iteration stage convergence is achieved
         for(int j=0;j<2;j++)
         {
-            if(pval[j]>=prop_chosen && i>=100 && icheck[j]==0)
+            if(pval[j]>=prop_chosen && i>=cfg.min_runs && icheck[j]==0)
             {
                 printf("component(%d),converged after (i=%d) runs, %f with relative tolerance(x 10(6)): %f\n",j+1,i,beta[j],1.0e6*fabs((beta[j]-tmean[j]))/tmean[j]);
                 icheck[j]=1;
             }
         }
-        if(min>=prop_chosen && i>=100) break;
+        if(min>=prop_chosen && i>=cfg.min_runs) break;
     }
 
     //return results
@@ -125,6 +1263,9 @@ int main()
 
     //gather runtime statistics for the random number generators...
     randy.get_num_calls();
+    metrics::add(MET_RAN_SHORT_CALLS,randy.rcall_internal[0]);
+    metrics::add(MET_RAN_LONG_CALLS,randy.rcall_internal[1]);
+    metrics::add(MET_RAN_GAUSS_CALLS,randy.rcall_internal[2]);
     //
     printf("#END OF TEST WITH SYNTHETIC DATA...\n");
     printf("####################################\n");
@@ -134,42 +1275,87 @@ int main()
     //Second part: test with experimental data is made
     printf("#START OF TEST WITH EXPERIMENTAL DATA...\n");
 
-    //load the experimentally collected data from tedaldi et al. into memory
-    exp.read_data();
-    exp.static_time=50.0;      //length of initial static period taken from tedaldi et al.
-    exp.set_static_int();      //load the length of the initial period
-
-    exp.static_calibration();  //compute the gyroscopic offsets statically
+    //load the experimentally collected data from tedaldi et al. into memory and
+    //compute the gyroscopic offsets statically over the initial static period
+    //(50 s in tedaldi et al.): they are the reference values
+    if(load_experiment(cfg,exp,tmean)==0) return 1;
 
     //*************************************************
     //now-as before-we make these gyroscopic calculations
     //dynamically...
-    double xstat[4],ystat[4],zstat[4];
+    double xstat[RECSTAT_ROBUST_SIZE]={0},ystat[RECSTAT_ROBUST_SIZE]={0},zstat[RECSTAT_ROBUST_SIZE]={0};
     double gyro[3];
+    int ns,nk[3];
+
+    //optional decimation of the raw samples before the recursion: they are
+    //integrated block by block only as far as the recursion needs them
+    decimator dec;
+    expdata::dynamic dsample;
+    int nraw=0;
+    dec.factor=cfg.decimate;
 
-    //use the reference value...
-    tmean[0]=exp.gyro_off.x;
-    tmean[1]=exp.gyro_off.y;
-    tmean[2]=exp.gyro_off.z;
     for(int j=0;j<3;j++) icheck[j]=0;
 
     i=1;
     for(;;)
     {
+        if(dec.push_block(exp.gyro_store,nraw,dsample)==0) break;   //end of data
+        nraw+=cfg.decimate;
         //copy the obtained data into the work-array
-        gyro[0]=exp.gyro_store[i-1].x;
-        gyro[1]=exp.gyro_store[i-1].y;
-        gyro[2]=exp.gyro_store[i-1].z;
+        gyro[0]=dsample.x;
+        gyro[1]=dsample.y;
+        gyro[2]=dsample.z;
         //update the statistical properties with the computed value
-        recstats.seq_update(xstat,gyro[0],i);
-        recstats.seq_update(ystat,gyro[1],i);
-        recstats.seq_update(zstat,gyro[2],i);
+        {
+            metrics_timer timer(MET_SEQ_UPDATE);
+            if(cfg.robust>0.0)
+            {
+                recstats.seq_update_robust(xstat,gyro[0],cfg.robust);
+                recstats.seq_update_robust(ystat,gyro[1],cfg.robust);
+                recstats.seq_update_robust(zstat,gyro[2],cfg.robust);
+            }
+            else
+            {
+                recstats.seq_update(xstat,gyro[0],i);
+                recstats.seq_update(ystat,gyro[1],i);
+                recstats.seq_update(zstat,gyro[2],i);
+            }
+        }
+        metrics::add(MET_SAMPLES_UPDATED,1);
         //compute the acceptance probability for each component and the lowest overall
         i++;
+        ns=(i-1)*cfg.decimate+1;   //run counter in raw samples (the minimum of runs counts decimated samples)
         min=1.1;
-        pval[0]=recstats.seq_accept_probability(xstat,fractional_chosen);
-        pval[1]=recstats.seq_accept_probability(ystat,fractional_chosen);
-        pval[2]=recstats.seq_accept_probability(zstat,fractional_chosen);
+        {
+            metrics_timer timer(MET_SEQ_ACCEPT);
+            if(cfg.robust>0.0 && !recstat::robust_seeded(xstat))
+            {
+                //no probability before the warm-up of the gate is complete
+                pval[0]=pval[1]=pval[2]=0.0;
+            }
+            else if(cfg.decimate>1)
+            {
+                //number of decimated samples in the recursion of each component
+                nk[0]=(cfg.robust>0.0) ? (int) xstat[RECSTAT_ROBUST_ACCEPTED] : i-1;
+                nk[1]=(cfg.robust>0.0) ? (int) ystat[RECSTAT_ROBUST_ACCEPTED] : i-1;
+                nk[2]=(cfg.robust>0.0) ? (int) zstat[RECSTAT_ROBUST_ACCEPTED] : i-1;
+                pval[0]=decimator::seq_accept_probability(xstat,fractional_chosen,nk[0],cfg.decimate);
+                pval[1]=decimator::seq_accept_probability(ystat,fractional_chosen,nk[1],cfg.decimate);
+                pval[2]=decimator::seq_accept_probability(zstat,fractional_chosen,nk[2],cfg.decimate);
+            }
+            else
+            {
+                pval[0]=recstats.seq_accept_probability(xstat,fractional_chosen);
+                pval[1]=recstats.seq_accept_probability(ystat,fractional_chosen);
+                pval[2]=recstats.seq_accept_probability(zstat,fractional_chosen);
+            }
+        }
+        if(tracing)
+        {
+            trace.record(1,0,ns,xstat,pval[0]);
+            trace.record(1,1,ns,ystat,pval[1]);
+            trace.record(1,2,ns,zstat,pval[2]);
+        }
         for(int j=0;j<3;j++) { if(min>=pval[j]) min=pval[j];}  //store the lowest acceptance proability
 
         //store the mean of means for later usage(!)
@@ -180,13 +1366,14 @@ int main()
         //for test purposes: check and store at which iteration stage convergence is achieved
         for(int j=0;j<3;j++)
         {
-            if(pval[j]>=prop_chosen && i>=100 && icheck[j]==0)
+            if(pval[j]>=prop_chosen && i>=cfg.min_runs && icheck[j]==0)
             {
-                printf("component(%d),converged after (i=%d) runs, %f with relative tolerance(x 10(6)): %f\n",j+1,i,beta[j],1.0e6*fabs((beta[j]-tmean[j]))/tmean[j]);
+                printf("component(%d),converged after (i=%d) runs, %f with relative tolerance(x 10(6)): %f\n",j+1,ns,beta[j],1.0e6*fabs((beta[j]-tmean[j]))/tmean[j]);
+                metrics::observe(MET_CONVERGENCE_X+j,ns-1);
                 icheck[j]=1;
             }
         }
-        if(min>=prop_chosen && i>=100) break;
+        if(min>=prop_chosen && i>=cfg.min_runs) break;
     }
     printf("RESULTS**********************:\n");
     printf("for fractional accuracy %f and acceptance probability %f the following results are obtained:\n",fractional_chosen, prop_chosen);
@@ -203,12 +1390,24 @@ int main()
         printf("Result [%d]:component: %f, true value: %f, relative tolerance( x 10(%d)): %f\n",(j+2),beta[j],tmean[j],icheck[j],pval[j]*fabs((beta[j]-tmean[j])/tmean[j]));
     }
     printf("Result [5]:average relative accuracy achieved( x 10(4)): %f\n",1.0e4*(fabs(gyro_total-comp_total)/gyro_total));
+    if(cfg.robust>0.0)
+    {
+        printf("Result [6]:rejected samples (gate %f standard deviations): %d %d %d\n",cfg.robust,(int) xstat[RECSTAT_ROBUST_REJECTED],
+               (int) ystat[RECSTAT_ROBUST_REJECTED],(int) zstat[RECSTAT_ROBUST_REJECTED]);
+    }
     printf("END OF RESULTS************\n");
     //***********************************************
     //+++++++++++++++++++++++++++++++++++++++++++++++
     //***********************************************
     printf("#END OF TEST WITH EXPERIMENTAL DATA...\n");
 
+    if(tracing)
+    {
+        trace.close();
+        printf("trace: %lu records written\n",trace.written);
+    }
+    if(metrics::enabled && metrics::dump(cfg.metrics.c_str())==0) return 1;
+
     return 0;
 
 }
\ No newline at end of file
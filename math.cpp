@@ -46,7 +46,7 @@ int mathb::check_bounds(double x,double x1, double x2)
 
 }
 
-int mathb::locate(double x, double xx[], int n)
+int mathb::locate(double x, const double xx[], int n)
 ///******************************************************************
 /// LOCATE
 /// -----------------------------------------------------------------
@@ -90,3 +90,36 @@ int mathb::locate(double x, double xx[], int n)
     {return jl;}
 
 }
+
+double mathb::erfinv(double y)
+///******************************************************************
+/// ERFINV
+/// -----------------------------------------------------------------
+/// computes the inverse of the error function by newton iteration
+/// starting from the approximation of Winitzki. the result z
+/// fulfills erf(z)=y to machine accuracy
+/// -----------------------------------------------------------------
+/// y    - IN: function value in (-1:1)
+/// -----------------------------------------------------------------
+{
+    const double a=0.147,pi=3.14159265358979323846;
+    double l,t,z,dz;
+
+    if(y<=-1.0) return -HUGE_VAL;
+    if(y>=1.0) return HUGE_VAL;
+
+    //initial guess
+    l=log(1.0-y*y);
+    t=2.0/(pi*a)+0.5*l;
+    z=sqrt(sqrt(t*t-l/a)-t);
+    if(y<0.0) z=-z;
+
+    //newton iterations on erf(z)-y
+    for(int i=0;i<50;i++)
+    {
+        dz=(erf(z)-y)/(2.0/sqrt(pi)*exp(-z*z));
+        z-=dz;
+        if(fabs(dz)<=1.0e-15*fabs(z)) break;
+    }
+    return z;
+}
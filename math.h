@@ -59,7 +59,18 @@ public:
     /// -----------------------------------------------------------------
     /// !!! NOTE: this subroutine is used under the licensing conditions
     /// !!! of numerical recipes of Press et al.
-    static int locate(double x, double xx[], int n);
+    static int locate(double x, const double xx[], int n);
+
+    ///******************************************************************
+    /// ERFINV
+    /// -----------------------------------------------------------------
+    /// computes the inverse of the error function by newton iteration
+    /// starting from the approximation of Winitzki. the result z
+    /// fulfills erf(z)=y to machine accuracy
+    /// -----------------------------------------------------------------
+    /// y    - IN: function value in (-1:1)
+    /// -----------------------------------------------------------------
+    static double erfinv(double y);
 
 
 };
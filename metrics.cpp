@@ -0,0 +1,286 @@
+//
+// Created by stefan on 24.02.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "metrics.h"
+#include <string.h>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#define MET_TIMER 0
+#define MET_HISTOGRAM 1
+#define MET_COUNTER 2
+
+//description of each metric in the order of metric_id
+static const struct metric_info
+{
+    const char *name;
+    const char *label;
+    int kind;
+    const char *help;
+} met_info[MET_NUM]={
+    {"recgyro_read_data_nanoseconds","",MET_TIMER,"loading and parsing of the data file"},
+    {"recgyro_set_static_int_nanoseconds","",MET_TIMER,"location of the end of the static period"},
+    {"recgyro_static_calibration_nanoseconds","",MET_TIMER,"static calibration of the offsets"},
+    {"recgyro_seq_update_nanoseconds","",MET_TIMER,"seq_update of all components of one step"},
+    {"recgyro_seq_accept_nanoseconds","",MET_TIMER,"seq_accept_probability of all components of one step"},
+    {"recgyro_samples_to_convergence","axis=\"x\"",MET_HISTOGRAM,"samples until first convergence of a component"},
+    {"recgyro_samples_to_convergence","axis=\"y\"",MET_HISTOGRAM,"samples until first convergence of a component"},
+    {"recgyro_samples_to_convergence","axis=\"z\"",MET_HISTOGRAM,"samples until first convergence of a component"},
+    {"recgyro_samples_read_total","",MET_COUNTER,"samples loaded from data files"},
+    {"recgyro_samples_updated_total","",MET_COUNTER,"samples passed through the recursion"},
+    {"recgyro_random_calls_total","generator=\"ran_short\"",MET_COUNTER,"calls to the random number generators"},
+    {"recgyro_random_calls_total","generator=\"ran_long\"",MET_COUNTER,"calls to the random number generators"},
+    {"recgyro_random_calls_total","generator=\"ran_gauss\"",MET_COUNTER,"calls to the random number generators"},
+};
+
+//storage of one metric; every slot is written by a single thread only
+//such that relaxed load/store suffices and no locked instruction is used
+typedef struct metric_values
+{
+    atomic<uint64_t> count;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> max;
+    atomic<uint64_t> bucket[MET_BUCKETS];
+} metric_val;
+
+typedef struct metric_slot
+{
+    metric_val val[MET_NUM];
+} metric_slot;
+
+//sum of all slots as used for the output
+typedef struct metric_total
+{
+    uint64_t count,sum,max;
+    uint64_t bucket[MET_BUCKETS];
+} metric_tot;
+
+bool metrics::enabled=false;
+
+static mutex slot_lock;
+static vector<metric_slot*> slots;   //slots of all threads (kept until exit)
+static thread_local metric_slot *own_slot=NULL;
+
+static inline void bump(atomic<uint64_t> &a, uint64_t v)
+{
+    a.store(a.load(memory_order_relaxed)+v,memory_order_relaxed);
+}
+
+static metric_slot *get_slot()
+{
+    if(own_slot==NULL)
+    {
+        metric_slot *s=new metric_slot;
+        for(int k=0;k<MET_NUM;k++)
+        {
+            s->val[k].count.store(0);
+            s->val[k].sum.store(0);
+            s->val[k].max.store(0);
+            for(int b=0;b<MET_BUCKETS;b++) s->val[k].bucket[b].store(0);
+        }
+        lock_guard<mutex> guard(slot_lock);
+        slots.push_back(s);
+        own_slot=s;
+    }
+    return own_slot;
+}
+
+static void collect(metric_tot tot[])
+{
+    lock_guard<mutex> guard(slot_lock);
+
+    memset(tot,0,MET_NUM*sizeof(metric_tot));
+    for(size_t s=0;s<slots.size();s++)
+    {
+        for(int k=0;k<MET_NUM;k++)
+        {
+            metric_val &v=slots[s]->val[k];
+            tot[k].count+=v.count.load(memory_order_relaxed);
+            tot[k].sum+=v.sum.load(memory_order_relaxed);
+            if(v.max.load(memory_order_relaxed)>tot[k].max) tot[k].max=v.max.load(memory_order_relaxed);
+            for(int b=0;b<MET_BUCKETS;b++) tot[k].bucket[b]+=v.bucket[b].load(memory_order_relaxed);
+        }
+    }
+}
+
+uint64_t metrics::now()
+///******************************************************************
+/// NOW
+/// -----------------------------------------------------------------
+/// returns the monotonic clock in nanoseconds
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+{
+    return (uint64_t) chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void metrics::observe(int id, uint64_t v)
+///******************************************************************
+/// OBSERVE
+/// -----------------------------------------------------------------
+/// adds the value v to the histogram of the metric id (count, sum,
+/// maximum and bucket floor(log2(v))+1)
+/// -----------------------------------------------------------------
+/// id    - IN: identifier of the metric
+/// v     - IN: observed value (nanoseconds for timers)
+/// -----------------------------------------------------------------
+{
+    int b=0;
+
+    if(!enabled) return;
+    metric_val &m=get_slot()->val[id];
+    while(b<MET_BUCKETS-1 && (v>>b)!=0) b++;
+    bump(m.count,1);
+    bump(m.sum,v);
+    bump(m.bucket[b],1);
+    if(v>m.max.load(memory_order_relaxed)) m.max.store(v,memory_order_relaxed);
+}
+
+void metrics::add(int id, uint64_t v)
+///******************************************************************
+/// ADD
+/// -----------------------------------------------------------------
+/// increments the counter of the metric id by v
+/// -----------------------------------------------------------------
+/// id    - IN: identifier of the metric
+/// v     - IN: increment
+/// -----------------------------------------------------------------
+{
+    if(!enabled) return;
+    bump(get_slot()->val[id].sum,v);
+}
+
+void metrics::dump_json(FILE *fp)
+///******************************************************************
+/// DUMP_JSON
+/// -----------------------------------------------------------------
+/// sums up the slots of all threads and writes all metrics as a
+/// JSON object
+/// -----------------------------------------------------------------
+/// fp    - IN: output stream
+/// -----------------------------------------------------------------
+{
+    metric_tot tot[MET_NUM];
+    int nb;
+
+    collect(tot);
+    fprintf(fp,"{\n  \"metrics\": [\n");
+    for(int k=0;k<MET_NUM;k++)
+    {
+        fprintf(fp,"    {\"name\": \"%s\", \"labels\": \"",met_info[k].name);
+        //labels are given in prometheus syntax, quotes have to be escaped
+        for(const char *c=met_info[k].label;*c;c++) {if(*c=='"') fputc('\\',fp); fputc(*c,fp);}
+        if(met_info[k].kind==MET_COUNTER)
+        {
+            fprintf(fp,"\", \"type\": \"counter\", \"value\": %llu}",(unsigned long long) tot[k].sum);
+        }
+        else
+        {
+            fprintf(fp,"\", \"type\": \"%s\", \"count\": %llu, \"sum\": %llu, \"max\": %llu, \"mean\": %.3f, \"log2_buckets\": [",
+                    met_info[k].kind==MET_TIMER ? "timer" : "histogram",
+                    (unsigned long long) tot[k].count,(unsigned long long) tot[k].sum,(unsigned long long) tot[k].max,
+                    tot[k].count>0 ? (double) tot[k].sum/(double) tot[k].count : 0.0);
+            nb=MET_BUCKETS;
+            while(nb>0 && tot[k].bucket[nb-1]==0) nb--;
+            for(int b=0;b<nb;b++) fprintf(fp,"%s%llu",b>0 ? ", " : "",(unsigned long long) tot[k].bucket[b]);
+            fprintf(fp,"]}");
+        }
+        fprintf(fp,"%s\n",k<MET_NUM-1 ? "," : "");
+    }
+    fprintf(fp,"  ]\n}\n");
+}
+
+void metrics::dump_prometheus(FILE *fp)
+///******************************************************************
+/// DUMP_PROMETHEUS
+/// -----------------------------------------------------------------
+/// sums up the slots of all threads and writes all metrics in the
+/// Prometheus text exposition format
+/// -----------------------------------------------------------------
+/// fp    - IN: output stream
+/// -----------------------------------------------------------------
+{
+    metric_tot tot[MET_NUM];
+    const char *sep;
+    uint64_t cum;
+    int nb;
+
+    collect(tot);
+    for(int k=0;k<MET_NUM;k++)
+    {
+        //HELP and TYPE only once per metric family
+        if(k==0 || strcmp(met_info[k].name,met_info[k-1].name)!=0)
+        {
+            fprintf(fp,"# HELP %s %s\n",met_info[k].name,met_info[k].help);
+            fprintf(fp,"# TYPE %s %s\n",met_info[k].name,met_info[k].kind==MET_COUNTER ? "counter" : "histogram");
+        }
+        sep=(met_info[k].label[0]!='\0') ? "," : "";
+        if(met_info[k].kind==MET_COUNTER)
+        {
+            if(sep[0]!='\0') fprintf(fp,"%s{%s} %llu\n",met_info[k].name,met_info[k].label,(unsigned long long) tot[k].sum);
+            else fprintf(fp,"%s %llu\n",met_info[k].name,(unsigned long long) tot[k].sum);
+            continue;
+        }
+        //bucket b holds the values v with 2^(b-1)<=v<2^b
+        nb=MET_BUCKETS;
+        while(nb>0 && tot[k].bucket[nb-1]==0) nb--;
+        cum=0;
+        for(int b=0;b<nb;b++)
+        {
+            cum+=tot[k].bucket[b];
+            fprintf(fp,"%s_bucket{%s%sle=\"%llu\"} %llu\n",met_info[k].name,met_info[k].label,sep,
+                    (unsigned long long) (((uint64_t) 1<<b)-1),(unsigned long long) cum);
+        }
+        fprintf(fp,"%s_bucket{%s%sle=\"+Inf\"} %llu\n",met_info[k].name,met_info[k].label,sep,(unsigned long long) tot[k].count);
+        if(sep[0]!='\0')
+        {
+            fprintf(fp,"%s_sum{%s} %llu\n",met_info[k].name,met_info[k].label,(unsigned long long) tot[k].sum);
+            fprintf(fp,"%s_count{%s} %llu\n",met_info[k].name,met_info[k].label,(unsigned long long) tot[k].count);
+        }
+        else
+        {
+            fprintf(fp,"%s_sum %llu\n",met_info[k].name,(unsigned long long) tot[k].sum);
+            fprintf(fp,"%s_count %llu\n",met_info[k].name,(unsigned long long) tot[k].count);
+        }
+    }
+}
+
+int metrics::dump(const char *fname)
+///******************************************************************
+/// DUMP
+/// -----------------------------------------------------------------
+/// writes the metrics into the file fname, in Prometheus format if
+/// the name ends with ".prom" and as JSON otherwise. returns 1 on
+/// success and 0 if the file could not be created
+/// -----------------------------------------------------------------
+/// fname - IN: name of the output file
+/// -----------------------------------------------------------------
+{
+    FILE *fp;
+    size_t l=strlen(fname);
+
+    fp=fopen(fname,"w");
+    if(fp==NULL)
+    {
+        printf("could not create metrics file: %s\n",fname);
+        return 0;
+    }
+    if(l>5 && strcmp(fname+l-5,".prom")==0) dump_prometheus(fp);
+    else dump_json(fp);
+    fclose(fp);
+    return 1;
+}
@@ -0,0 +1,147 @@
+//
+// Created by stefan on 24.02.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_METRICS_H
+#define PUBLICATION_RECURSIVE_MEAN_METRICS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+using namespace std;
+
+//identifiers of all metrics, the names are given in metrics.cpp
+enum metric_id
+{
+    MET_READ_DATA=0,        //timer: loading and parsing of the data file
+    MET_SET_STATIC_INT,     //timer: expdata::set_static_int
+    MET_STATIC_CALIBRATION, //timer: expdata::static_calibration
+    MET_SEQ_UPDATE,         //timer: seq_update of all components of one step
+    MET_SEQ_ACCEPT,         //timer: seq_accept_probability of all components of one step
+    MET_CONVERGENCE_X,      //histogram: samples to convergence of component x
+    MET_CONVERGENCE_Y,      //histogram: samples to convergence of component y
+    MET_CONVERGENCE_Z,      //histogram: samples to convergence of component z
+    MET_SAMPLES_READ,       //counter: samples loaded from data files
+    MET_SAMPLES_UPDATED,    //counter: samples passed through the recursion
+    MET_RAN_SHORT_CALLS,    //counter: calls to ranbase::ran_short
+    MET_RAN_LONG_CALLS,     //counter: calls to ranbase::ran_long
+    MET_RAN_GAUSS_CALLS,    //counter: calls to ranbase::ran_gauss
+    MET_NUM
+};
+
+#define MET_BUCKETS 64
+
+//*******************************************************************
+// lightweight metrics for the calibration pipeline: monotonic clock
+// timers, counters and histograms with power-of-2 buckets. Every
+// thread writes into its own slot (no locks, no shared cache lines on
+// the hot path); the slots are only summed up when the metrics are
+// dumped, which may happen at any time and from any thread. All
+// recording is skipped unless metrics::enabled is set.
+//*******************************************************************
+
+class metrics {
+
+public:
+
+    static bool enabled;
+
+    ///******************************************************************
+    /// NOW
+    /// -----------------------------------------------------------------
+    /// returns the monotonic clock in nanoseconds
+    /// -----------------------------------------------------------------
+    /// no input arguments
+    /// -----------------------------------------------------------------
+
+    static uint64_t now();
+
+    ///******************************************************************
+    /// OBSERVE
+    /// -----------------------------------------------------------------
+    /// adds the value v to the histogram of the metric id (count, sum,
+    /// maximum and bucket floor(log2(v))+1)
+    /// -----------------------------------------------------------------
+    /// id    - IN: identifier of the metric
+    /// v     - IN: observed value (nanoseconds for timers)
+    /// -----------------------------------------------------------------
+
+    static void observe(int id, uint64_t v);
+
+    ///******************************************************************
+    /// ADD
+    /// -----------------------------------------------------------------
+    /// increments the counter of the metric id by v
+    /// -----------------------------------------------------------------
+    /// id    - IN: identifier of the metric
+    /// v     - IN: increment
+    /// -----------------------------------------------------------------
+
+    static void add(int id, uint64_t v);
+
+    ///******************************************************************
+    /// DUMP_JSON
+    /// -----------------------------------------------------------------
+    /// sums up the slots of all threads and writes all metrics as a
+    /// JSON object
+    /// -----------------------------------------------------------------
+    /// fp    - IN: output stream
+    /// -----------------------------------------------------------------
+
+    static void dump_json(FILE *fp);
+
+    ///******************************************************************
+    /// DUMP_PROMETHEUS
+    /// -----------------------------------------------------------------
+    /// sums up the slots of all threads and writes all metrics in the
+    /// Prometheus text exposition format
+    /// -----------------------------------------------------------------
+    /// fp    - IN: output stream
+    /// -----------------------------------------------------------------
+
+    static void dump_prometheus(FILE *fp);
+
+    ///******************************************************************
+    /// DUMP
+    /// -----------------------------------------------------------------
+    /// writes the metrics into the file fname, in Prometheus format if
+    /// the name ends with ".prom" and as JSON otherwise. returns 1 on
+    /// success and 0 if the file could not be created
+    /// -----------------------------------------------------------------
+    /// fname - IN: name of the output file
+    /// -----------------------------------------------------------------
+
+    static int dump(const char *fname);
+
+};
+
+//*******************************************************************
+// scope timer: observes the time between construction and destruction
+//*******************************************************************
+
+class metrics_timer {
+
+private:
+
+    int id;
+    uint64_t t0;
+
+public:
+
+    explicit metrics_timer(int metric) : id(metric), t0(metrics::enabled ? metrics::now() : 0) {}
+    ~metrics_timer() {if(t0!=0) metrics::observe(id,metrics::now()-t0);}
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_METRICS_H
@@ -0,0 +1,165 @@
+//
+// Created by stefan on 01.06.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "multichan.h"
+#include "recstats.h"
+#include "math.h"
+#include <math.h>
+#include <utility>
+
+//the recursion of recstat::seq_update on slots 0..na-1 with their own
+//sample counts, term by term as in mean and var such that the results are
+//identical. the arrays do not overlap (__restrict), so the loop is mapped
+//onto vector instructions
+static void update_slots(double *__restrict m, double *__restrict v, double *__restrict mm, double *__restrict vm,
+                         double *__restrict cnt, const double *__restrict x, int na)
+{
+    for(int k=0;k<na;k++)
+    {
+        double n0=cnt[k],n1=n0+1.0,w1,w2,d;
+
+        w1=(n1-2.0)/n0;
+        w2=n1/(n0*n0);
+        m[k]=(n0*m[k]+x[k])/n1;
+        d=x[k]-m[k];
+        v[k]=w1*v[k]+w2*(d*d);
+        mm[k]=(n0*mm[k]+m[k])/n1;
+        d=m[k]-mm[k];
+        vm[k]=w1*vm[k]+w2*(d*d);
+        cnt[k]=n1;
+    }
+}
+
+//the first sample (the case n=1 of var), all channels take it together
+//such that update_slots needs no branch
+static void first_slots(double m[], double v[], double mm[], double vm[], double cnt[], const double x[], int na)
+{
+    for(int k=0;k<na;k++)
+    {
+        m[k]=mm[k]=x[k];
+        v[k]=vm[k]=0.0;
+        cnt[k]=1.0;
+    }
+}
+
+void multichan::setup(int nc)
+///******************************************************************
+/// SETUP
+/// -----------------------------------------------------------------
+/// creates nc channels without samples (the parameters above have to
+/// be set before)
+/// -----------------------------------------------------------------
+/// nc    - IN: number of channels
+/// -----------------------------------------------------------------
+{
+    m.assign(nc,0.0);
+    v.assign(nc,0.0);
+    mm.assign(nc,0.0);
+    vm.assign(nc,0.0);
+    cnt.assign(nc,0.0);
+    chan.resize(nc);
+    slot.resize(nc);
+    for(int c=0;c<nc;c++) chan[c]=slot[c]=c;
+    xs.assign(nc,0.0);
+    pass.clear();
+    pass.reserve(nc);
+    iconv.assign(nc,0);
+    offset.assign(nc,0.0);
+    frozen.assign(nc,0);
+    nact=nopen=nc;
+    step=updates=revised=0;
+    //lowered by a relative margin so that rounding never hides a channel
+    //which the exact test of seq_accept_probability accepts
+    z=mathb::erfinv(prop_chosen)*(1.0-1.0e-9);
+}
+
+void multichan::swap_slots(int a, int b)
+{
+    swap(m[a],m[b]);
+    swap(v[a],v[b]);
+    swap(mm[a],mm[b]);
+    swap(vm[a],vm[b]);
+    swap(cnt[a],cnt[b]);
+    swap(chan[a],chan[b]);
+    slot[chan[a]]=a;
+    slot[chan[b]]=b;
+}
+
+int multichan::update(const double x[])
+///******************************************************************
+/// UPDATE
+/// -----------------------------------------------------------------
+/// feeds the sample x[c] of every channel c into the recursions of
+/// the active channels, freezes those which converged and returns
+/// the number of channels which did not converge yet
+/// -----------------------------------------------------------------
+/// x     - IN: samples of all channels
+/// -----------------------------------------------------------------
+{
+    recstat rs;
+    int nact_before=nact;
+
+    step++;
+    //a recheck lets the frozen slots (behind the active ones) take part
+    if(retire && recheck>0 && step%recheck==0) nact=size();
+
+    for(int k=0;k<nact;k++) xs[k]=x[chan[k]];
+    if(step==1) first_slots(m.data(),v.data(),mm.data(),vm.data(),cnt.data(),xs.data(),nact);
+    else update_slots(m.data(),v.data(),mm.data(),vm.data(),cnt.data(),xs.data(),nact);
+    updates+=nact;
+
+    //screening without erf, candidates are confirmed with the exact test
+    //(without retirement only for the channels which did not converge yet)
+    pass.clear();
+    for(int k=0;k<nact;k++)
+    {
+        double c=fractional_chosen*mm[k];
+        if(!retire && iconv[chan[k]]!=0) continue;
+        if(cnt[k]+1.0<min_runs || !(c>0.0 && c*c>=2.0*z*z*vm[k])) continue;
+        double stat[4]={m[k],v[k],mm[k],vm[k]};
+        if(rs.seq_accept_probability(stat,fractional_chosen)>=prop_chosen) pass.push_back(k);
+    }
+
+    //frozen slots of a recheck which failed the test are reopened
+    for(int k=nact_before,p=0;k<nact;k++)
+    {
+        while(p<(int) pass.size() && pass[p]<k) p++;
+        if(p==(int) pass.size() || pass[p]!=k) frozen[chan[k]]=0;
+    }
+
+    //freezing: descending, so the slot swapped in from the end was tested already
+    for(int p=(int) pass.size()-1;p>=0;p--)
+    {
+        int k=pass[p],c=chan[k];
+        if(iconv[c]==0)
+        {
+            iconv[c]=(int) cnt[k];
+            offset[c]=mm[k];
+            nopen--;
+        }
+        else if(retire && fabs(mm[k]-offset[c])>fractional_chosen*fabs(offset[c]))
+        {
+            offset[c]=mm[k];
+            revised++;
+        }
+        if(retire)
+        {
+            frozen[c]=1;
+            swap_slots(k,--nact);
+        }
+    }
+
+    return nopen;
+}
@@ -0,0 +1,104 @@
+//
+// Created by stefan on 01.06.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_MULTICHAN_H
+#define PUBLICATION_RECURSIVE_MEAN_MULTICHAN_H
+
+#include <vector>
+using namespace std;
+
+//*******************************************************************
+// calibration of many channels (components of one or several sensors)
+// sampled together, each with its own convergence: the recursion of
+// recstat::seq_update runs on arrays of the four quantities (structure
+// of arrays, bitwise the same results as seq_update), and a channel is
+// frozen with its offset as soon as it passes the test of main.cpp
+// (acceptance probability >= prop_chosen after at least min_runs
+// runs), instead of being updated until the last channel converges.
+// The unfinished channels are kept compacted at the front of the
+// arrays (a frozen channel swaps place with the last active one), so
+// the update loop runs branch free over contiguous active slots, which
+// the compiler maps onto vector instructions. The test is screened as
+// in opgrid (f*mm>=erfinv(p)*sqrt(2*vm), no erf) and only candidates
+// are confirmed with seq_accept_probability. With recheck>0 every
+// recheck-th sample also enters the frozen channels: a channel which
+// no longer passes the test is reopened until it passes again, and its
+// offset is revised if it moved by more than fractional_chosen.
+// retire=false keeps all channels in the recursion until all have
+// converged, which is the loop of main.cpp (for comparison).
+//*******************************************************************
+
+class multichan {
+
+private:
+
+    //state of the slots, the active ones in 0..nact-1
+    vector<double> m,v,mm,vm; //mean, variance, mean of mean, variance of mean
+    vector<double> cnt;       //samples in the recursion of the slot
+    vector<int> chan;         //channel in the slot
+    vector<int> slot;         //slot of the channel
+    vector<double> xs;        //work array: samples of the active slots
+    vector<int> pass;         //work array: slots which passed the test
+    int nact=0;               //active slots
+    int nopen=0;              //channels which did not converge yet
+    long step=0;              //samples given to update
+    double z=0.0;             //lowered erfinv(prop_chosen)
+
+    void swap_slots(int a, int b);
+
+public:
+
+    double prop_chosen=0.9;   //acceptance probability
+    double fractional_chosen=0.005; //fractional accuracy
+    int min_runs=100;         //minimum number of runs as in main.cpp
+    int recheck=0;            //every recheck-th sample enters the frozen channels (0: never)
+    bool retire=true;         //false: no channel leaves the recursion before all converged
+
+    vector<int> iconv;        //samples of the channel at its (first) convergence, 0 if open
+    vector<double> offset;    //frozen offset of the channel
+    vector<int> frozen;       //1 while the channel is frozen
+    long updates=0;           //channel updates performed
+    long revised=0;           //offsets revised by a recheck
+
+    ///******************************************************************
+    /// SETUP
+    /// -----------------------------------------------------------------
+    /// creates nc channels without samples (the parameters above have to
+    /// be set before)
+    /// -----------------------------------------------------------------
+    /// nc    - IN: number of channels
+    /// -----------------------------------------------------------------
+
+    void setup(int nc);
+
+    ///******************************************************************
+    /// UPDATE
+    /// -----------------------------------------------------------------
+    /// feeds the sample x[c] of every channel c into the recursions of
+    /// the active channels, freezes those which converged and returns
+    /// the number of channels which did not converge yet
+    /// -----------------------------------------------------------------
+    /// x     - IN: samples of all channels
+    /// -----------------------------------------------------------------
+
+    int update(const double x[]);
+
+    int active() const {return nact;}
+    int size() const {return (int) chan.size();}
+    double estimate(int c) const {return mm[slot[c]];}
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_MULTICHAN_H
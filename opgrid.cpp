@@ -0,0 +1,166 @@
+//
+// Created by stefan on 17.02.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "opgrid.h"
+#include "recstats.h"
+#include "math.h"
+#include <math.h>
+#include <stdio.h>
+
+void opgrid::setup(const double f[], int nfrac, const double p[], int nprob, int na)
+///******************************************************************
+/// SETUP
+/// -----------------------------------------------------------------
+/// defines the grid as outer product of the fractional accuracies
+/// f[0..nfrac-1] and the acceptance probabilities p[0..nprob-1] and resets
+/// all results
+/// -----------------------------------------------------------------
+/// f     - IN: fractional accuracies
+/// nfrac - IN: number of fractional accuracies
+/// p     - IN: acceptance probabilities
+/// nprob - IN: number of acceptance probabilities
+/// na    - IN: number of axes (components)
+/// -----------------------------------------------------------------
+{
+    nf=nfrac;
+    np=nprob;
+    naxis=na;
+    ncell=nf*np;
+
+    fcell.resize(ncell);
+    pcell.resize(ncell);
+    zcell.resize(ncell);
+    cvec.resize(ncell);
+    cand.resize(ncell);
+    for(int k=0;k<nf;k++)
+    {
+        for(int l=0;l<np;l++)
+        {
+            fcell[k*np+l]=f[k];
+            pcell[k*np+l]=p[l];
+            //lowered by a relative margin so that rounding never hides a
+            //cell which the exact test of seq_accept_probability accepts
+            zcell[k*np+l]=mathb::erfinv(p[l])*(1.0-1.0e-9);
+        }
+    }
+
+    first_axis.assign(naxis*ncell,-1);
+    offset_axis.assign(naxis*ncell,0.0);
+    first_all.assign(ncell,-1);
+    offset_all.assign(ncell*naxis,0.0);
+    nopen_axis.assign(naxis,ncell);
+    nopen=ncell;
+}
+
+int opgrid::evaluate(double *stat[], int i)
+///******************************************************************
+/// EVALUATE
+/// -----------------------------------------------------------------
+/// tests all cells with the statistics of all axes after the update
+/// and records the first convergence index and offset of each cell.
+/// returns the number of cells for which not all axes converged yet
+/// such that the caller may stop as soon as it returns 0
+/// -----------------------------------------------------------------
+/// stat  - IN: stat-arrays of recstat::seq_update for each axis
+/// i     - IN: the run counter as used in main.cpp
+/// -----------------------------------------------------------------
+{
+    recstat recstats;
+    double c,cmin=HUGE_VAL;
+    int *first;
+    bool ok;
+
+    if(i<min_runs) return nopen;
+
+    for(int a=0;a<naxis;a++)
+    {
+        //f-independent part of the argument of erf
+        c=(stat[a][3]>0.0) ? stat[a][2]/sqrt(2.0*stat[a][3]) : HUGE_VAL;
+        if(c<cmin) cmin=c;
+        if(nopen_axis[a]==0) continue;
+
+        first=&first_axis[a*ncell];
+        for(int k=0;k<ncell;k++)
+        {
+            cvec[k]=fcell[k]*c;
+            cand[k]=(first[k]<0) & (cvec[k]>=zcell[k]);
+        }
+        for(int k=0;k<ncell;k++)
+        {
+            if(!cand[k]) continue;
+            if(recstats.seq_accept_probability(stat[a],fcell[k])>=pcell[k])
+            {
+                first[k]=i;
+                offset_axis[a*ncell+k]=stat[a][2];
+                nopen_axis[a]--;
+            }
+        }
+    }
+
+    //all axes together: the lowest probability belongs to the lowest c
+    for(int k=0;k<ncell;k++)
+    {
+        cvec[k]=fcell[k]*cmin;
+        cand[k]=(first_all[k]<0) & (cvec[k]>=zcell[k]);
+    }
+    for(int k=0;k<ncell;k++)
+    {
+        if(!cand[k]) continue;
+        ok=true;
+        for(int a=0;a<naxis && ok;a++) ok=(recstats.seq_accept_probability(stat[a],fcell[k])>=pcell[k]);
+        if(ok)
+        {
+            first_all[k]=i;
+            for(int a=0;a<naxis;a++) offset_all[k*naxis+a]=stat[a][2];
+            nopen--;
+        }
+    }
+
+    return nopen;
+}
+
+void opgrid::print_results(const double ref[])
+///******************************************************************
+/// PRINT_RESULTS
+/// -----------------------------------------------------------------
+/// prints for every cell the first convergence index and offset of
+/// each axis and of all axes together and, if a reference is given,
+/// the largest relative deviation of the offsets of all axes from it
+/// -----------------------------------------------------------------
+/// ref   - IN: reference offset of each axis (nullptr: none)
+/// -----------------------------------------------------------------
+{
+    double tol;
+
+    printf("OPERATING POINTS**************:\n");
+    printf("# fractional probability | per component: i offset | all components: i offsets%s\n",
+           (ref!=nullptr) ? " | max relative tolerance(x 10(6))" : "");
+    for(int k=0;k<ncell;k++)
+    {
+        printf("%f %f |",fcell[k],pcell[k]);
+        for(int a=0;a<naxis;a++) printf(" %d %f",first_axis[a*ncell+k],offset_axis[a*ncell+k]);
+        printf(" | %d",first_all[k]);
+        for(int a=0;a<naxis;a++) printf(" %f",offset_all[k*naxis+a]);
+        if(ref!=nullptr)
+        {
+            tol=0.0;
+            for(int a=0;a<naxis;a++) tol=fmax(tol,fabs(offset_all[k*naxis+a]-ref[a])/fabs(ref[a]));
+            if(first_all[k]<0) printf(" | -");
+            else printf(" | %f",1.0e6*tol);
+        }
+        printf("\n");
+    }
+    printf("END OF OPERATING POINTS*******\n");
+}
@@ -0,0 +1,99 @@
+//
+// Created by stefan on 17.02.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_OPGRID_H
+#define PUBLICATION_RECURSIVE_MEAN_OPGRID_H
+
+#include <vector>
+using namespace std;
+
+//*******************************************************************
+// evaluation of a whole grid of operating points (fractional accuracy
+// f, acceptance probability p) on a single run of the recursion. The
+// recursion of recstat::seq_update does not depend on (f,p) and since
+// erf is monotonic the test erf(f*c)>=p of seq_accept_probability with
+// c=stat[2]/sqrt(2*stat[3]) is equivalent to f*c>=erfinv(p). Hence each
+// step costs one division and square root per axis plus a vectorizable
+// multiply and compare per cell; only candidate cells are confirmed
+// with the exact erf-test of seq_accept_probability.
+//*******************************************************************
+
+class opgrid {
+
+private:
+
+    vector<double> fcell;    //fractional accuracy of each cell
+    vector<double> pcell;    //acceptance probability of each cell
+    vector<double> zcell;    //slightly lowered threshold erfinv(p) of each cell
+    vector<double> cvec;     //work array: f*c of each cell
+    vector<char> cand;       //work array: candidate cells
+    vector<int> nopen_axis;  //number of cells not yet converged for each axis
+    int nopen;               //number of cells not yet converged for all axes
+
+public:
+
+    int nf=0,np=0,ncell=0,naxis=0;
+    int min_runs=100;                //minimum number of runs as in main.cpp
+
+    vector<int> first_axis;          //[axis*ncell+cell] first convergence index of each axis
+    vector<double> offset_axis;      //[axis*ncell+cell] mean of mean at that index
+    vector<int> first_all;           //[cell] first index at which all axes are converged
+    vector<double> offset_all;       //[cell*naxis+axis] mean of mean of all axes at that index
+
+    ///******************************************************************
+    /// SETUP
+    /// -----------------------------------------------------------------
+    /// defines the grid as outer product of the fractional accuracies
+    /// f[0..nfrac-1] and the acceptance probabilities p[0..nprob-1] and resets
+    /// all results
+    /// -----------------------------------------------------------------
+    /// f     - IN: fractional accuracies
+    /// nfrac - IN: number of fractional accuracies
+    /// p     - IN: acceptance probabilities
+    /// nprob - IN: number of acceptance probabilities
+    /// na    - IN: number of axes (components)
+    /// -----------------------------------------------------------------
+
+    void setup(const double f[], int nfrac, const double p[], int nprob, int na);
+
+    ///******************************************************************
+    /// EVALUATE
+    /// -----------------------------------------------------------------
+    /// tests all cells with the statistics of all axes after the update
+    /// and records the first convergence index and offset of each cell.
+    /// returns the number of cells for which not all axes converged yet
+    /// such that the caller may stop as soon as it returns 0
+    /// -----------------------------------------------------------------
+    /// stat  - IN: stat-arrays of recstat::seq_update for each axis
+    /// i     - IN: the run counter as used in main.cpp
+    /// -----------------------------------------------------------------
+
+    int evaluate(double *stat[], int i);
+
+    ///******************************************************************
+    /// PRINT_RESULTS
+    /// -----------------------------------------------------------------
+    /// prints for every cell the first convergence index and offset of
+    /// each axis and of all axes together and, if a reference is given,
+    /// the largest relative deviation of the offsets of all axes from it
+    /// -----------------------------------------------------------------
+    /// ref   - IN: reference offset of each axis (nullptr: none)
+    /// -----------------------------------------------------------------
+
+    void print_results(const double ref[]=nullptr);
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_OPGRID_H
@@ -0,0 +1,461 @@
+//
+// Created by stefan on 20.04.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+//golden-result oracle: the synthetic run of main.cpp, both data files given in
+//"dnames", the parsed samples and the random number sequences are collected
+//as trace records (format of tracer.h) and either stored as golden file or
+//compared with a stored golden file. The recursion is run by an exchangeable
+//engine (the reference recstat, the single precision recstatf or the fixed-
+//point recstatq); every quantity is compared with its own tolerance, given
+//in ULPs (0: bit-exact), relative or absolute.
+//usage: rec_gyro_oracle record <golden file>
+//       rec_gyro_oracle check <golden file> [double|float|fixed]
+//                       [--tol <quantity> <ulp|rel|abs> <value>]...
+
+#include "baserandom.h"
+#include "recstats.h"
+#include "reckernels.h"
+#include "expdata.h"
+#include "tracer.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <memory>
+using namespace std;
+
+//series of the golden records
+#define ORACLE_SYNTH 0        //synthetic data (axis 0: gauss, 1: uniform)
+#define ORACLE_GYRO 1         //gyroscopic data file (axes 0..2)
+#define ORACLE_ACC 2          //acceleration data file (axes 0..2)
+#define ORACLE_RNG 3          //random numbers (axis 0: ran_short, 1: ran_long, 2: ran_gauss)
+#define ORACLE_DATA_GYRO 4    //parsed samples of the gyroscopic file (axis 0..3: t,x,y,z)
+#define ORACLE_DATA_ACC 5     //parsed samples of the acceleration file
+#define ORACLE_RESULT 6       //per component: convergence index, offsets, static reference
+
+#define ORACLE_SYNTH_STEPS 20000  //steps of the synthetic run
+#define ORACLE_DENSE 1024         //every step up to here is stored ...
+#define ORACLE_STRIDE 256         //... then every ORACLE_STRIDE-th and the last one
+#define ORACLE_RNG_COUNT 1024     //numbers per random number generator
+
+static const double prop_chosen=0.9;
+static const double fractional_chosen=0.005;
+
+//compared quantities
+enum quantity {Q_DATA=0,Q_RNG,Q_MEAN,Q_VAR,Q_MEANMEAN,Q_VARMEAN,Q_PROB,Q_ICONV,Q_OFFSET,Q_STATIC,Q_NUM};
+static const char *qname[Q_NUM]={"data","rng","mean","variance","mean_of_mean","variance_of_mean",
+                                 "probability","convergence","offset","static"};
+
+//tolerance of a quantity
+enum tol_mode {TOL_ULP=0,TOL_REL,TOL_ABS};
+typedef struct oracle_tolerance
+{
+    tol_mode mode;
+    double value;
+} tolerance;
+
+//*******************************************************************
+// engine running the recursion of one time series; all values are
+// returned as absolute values (as recstat::seq_update)
+//*******************************************************************
+
+class oracle_engine {
+
+public:
+
+    virtual ~oracle_engine() {}
+    virtual void update(double x, int n)=0;
+    virtual void state(double s[])=0;
+    virtual double prob()=0;
+
+};
+
+class engine_double : public oracle_engine {
+
+    recstat rs;
+    double stat[4]={0.0,0.0,0.0,0.0};
+
+public:
+
+    void update(double x, int n) {rs.seq_update(stat,x,n);}
+    void state(double s[]) {for(int j=0;j<4;j++) s[j]=stat[j];}
+    double prob() {return rs.seq_accept_probability(stat,fractional_chosen);}
+
+};
+
+class engine_float : public oracle_engine {
+
+    recstatf rs;
+
+public:
+
+    void update(double x, int n) {rs.seq_update((float) x,n);}
+    void state(double s[])
+    {
+        s[0]=(double) rs.ref+(double) rs.stat[0];
+        s[1]=(double) rs.stat[1];
+        s[2]=rs.offset();
+        s[3]=(double) rs.stat[3];
+    }
+    double prob() {return (double) rs.seq_accept_probability((float) fractional_chosen);}
+
+};
+
+class engine_fixed : public oracle_engine {
+
+    recstatq rs;
+
+public:
+
+    void update(double x, int n) {rs.seq_update((int32_t) lround(x*(double) (1<<RECQ_DATA_BITS)),n);}
+    void state(double s[])
+    {
+        const double scale=1.0/(double) (1<<RECQ_DATA_BITS);
+        s[0]=((double) rs.ref+(double) rs.stat[0])*scale;
+        s[1]=(double) rs.stat[1]*scale;
+        s[2]=rs.offset();
+        s[3]=(double) rs.stat[3]*scale;
+    }
+    double prob()
+    {
+        int32_t f=(int32_t) lround(fractional_chosen*(double) (1<<RECQ_FRAC_BITS));
+        return (double) rs.seq_accept_probability(f)/(double) (1<<RECQ_PROB_BITS);
+    }
+
+};
+
+static oracle_engine *make_engine(const char *name)
+{
+    if(strcmp(name,"double")==0) return new engine_double;
+    if(strcmp(name,"float")==0) return new engine_float;
+    if(strcmp(name,"fixed")==0) return new engine_fixed;
+    return NULL;
+}
+
+static trace_record make_record(int series, int axis, int i, const double s[], double p)
+{
+    trace_record r;
+
+    r.i=(uint32_t) i;
+    r.series=(uint8_t) series;
+    r.axis=(uint8_t) axis;
+    r.reserved=0;
+    for(int j=0;j<4;j++) r.stat[j]=(s!=NULL) ? s[j] : 0.0;
+    r.prob=p;
+    return r;
+}
+
+//steps stored in the golden file
+static bool stored(int k, int n)
+{
+    return k<=ORACLE_DENSE || k%ORACLE_STRIDE==0 || k==n;
+}
+
+//runs the recursion over the components x[0..nc-1] and appends the stored steps
+//and the results (convergence as in main.cpp, offsets, reference ref[])
+static void run_series(vector<trace_record> &out, const char *engine, int series, const vector<double> x[],
+                       int nc, const double ref[], int result_axis)
+{
+    vector<unique_ptr<oracle_engine> > e;
+    vector<int> iconv(nc,0);
+    vector<double> conv(nc,0.0),pconv(nc,0.0);
+    double s[4],p,res[4];
+    int n=(int) x[0].size();
+
+    for(int j=0;j<nc;j++) e.emplace_back(make_engine(engine));
+    for(int k=1;k<=n;k++)
+    {
+        for(int j=0;j<nc;j++)
+        {
+            e[j]->update(x[j][k-1],k);
+            e[j]->state(s);
+            p=e[j]->prob();
+            //the run counter i of main.cpp is k+1 after the update
+            if(p>=prop_chosen && k+1>=100 && iconv[j]==0)
+            {
+                iconv[j]=k+1;
+                conv[j]=s[2];
+                pconv[j]=p;
+            }
+            if(stored(k,n)) out.push_back(make_record(series,j,k,s,p));
+        }
+    }
+    for(int j=0;j<nc;j++)
+    {
+        e[j]->state(s);
+        res[0]=conv[j];
+        res[1]=s[2];
+        res[2]=ref[j];
+        res[3]=0.0;
+        out.push_back(make_record(ORACLE_RESULT,result_axis+j,iconv[j],res,pconv[j]));
+    }
+}
+
+//collects all records with the given engine, returns 0 if a data file is missing
+static int collect(vector<trace_record> &out, const char *engine)
+{
+    ranbase randy;
+    vector<double> x[4];
+    double ref[3],a,b,v[4]={0.0,0.0,0.0,0.0};
+    char fname[2][256];
+
+    //random number generators
+    randy.initialize_random_generators(1);
+    for(int k=1;k<=ORACLE_RNG_COUNT;k++) {v[0]=randy.ran_short(); out.push_back(make_record(ORACLE_RNG,0,k,v,0.0));}
+    for(int k=1;k<=ORACLE_RNG_COUNT;k++) {v[0]=randy.ran_long(); out.push_back(make_record(ORACLE_RNG,1,k,v,0.0));}
+    for(int k=1;k<=ORACLE_RNG_COUNT;k++) {v[0]=randy.ran_gauss(); out.push_back(make_record(ORACLE_RNG,2,k,v,0.0));}
+
+    //synthetic data exactly as in main.cpp
+    ref[0]=35747.234;
+    ref[1]=35634.458;
+    b=sqrt(12*979.56);
+    a=ref[1]-0.5*b;
+    randy.initialize_random_generators(1);
+    x[0].resize(ORACLE_SYNTH_STEPS);
+    x[1].resize(ORACLE_SYNTH_STEPS);
+    for(int k=0;k<ORACLE_SYNTH_STEPS;k++)
+    {
+        x[0][k]=ref[0]+987.34*randy.ran_gauss();
+        x[1][k]=a+randy.ran_short()*b;
+    }
+    run_series(out,engine,ORACLE_SYNTH,x,2,ref,0);
+
+    //both data files: parsed samples, static reference and recursion
+    expdata::read_names(fname[0],fname[1]);
+    for(int f=1;f>=0;f--)
+    {
+        expdata exp;
+        int series=(f==1) ? ORACLE_GYRO : ORACLE_ACC;
+
+        exp.data_size=expdata::read_file(fname[f],exp.gyro_store);
+        if(exp.data_size<=0)
+        {
+            printf("%s: %s\n",(exp.data_size<0) ? expdata::read_error(exp.data_size) : "no samples in file",fname[f]);
+            return 0;
+        }
+        for(int j=0;j<4;j++)
+        {
+            x[j].resize(exp.data_size);
+            if(j==0) for(int k=0;k<exp.data_size;k++) x[0][k]=exp.gyro_store.time(k);
+            else exp.gyro_store.copy_axis(j-1,0,exp.data_size,x[j].data());
+        }
+        for(int k=1;k<=exp.data_size;k++)
+        {
+            if(!stored(k,exp.data_size)) continue;
+            for(int j=0;j<4;j++)
+            {
+                v[0]=x[j][k-1];
+                out.push_back(make_record(series+3,j,k,v,0.0));
+            }
+        }
+        exp.static_time=50.0;
+        exp.set_static_int();
+        if(exp.static_calibration()==0) return 0;
+        ref[0]=exp.gyro_off.x;
+        ref[1]=exp.gyro_off.y;
+        ref[2]=exp.gyro_off.z;
+        run_series(out,engine,series,x+1,3,ref,2+3*(f==0));
+    }
+    return 1;
+}
+
+static int write_golden(const char *fname, const vector<trace_record> &r)
+{
+    trace_header hd={TRACE_MAGIC,TRACE_VERSION,(uint32_t) sizeof(trace_record),0};
+    FILE *fp;
+    int ok;
+
+    fp=fopen(fname,"wb");
+    if(fp==NULL) return 0;
+    ok=(fwrite(&hd,sizeof(hd),1,fp)==1 && fwrite(r.data(),sizeof(trace_record),r.size(),fp)==r.size());
+    if(fclose(fp)!=0) ok=0;
+    return ok;
+}
+
+static int read_golden(const char *fname, vector<trace_record> &r)
+{
+    trace_header hd;
+    trace_record rec;
+    FILE *fp;
+
+    fp=fopen(fname,"rb");
+    if(fp==NULL) return 0;
+    if(fread(&hd,sizeof(hd),1,fp)!=1 || hd.magic!=TRACE_MAGIC || hd.version<1 || hd.version>TRACE_VERSION
+       || hd.record_size!=sizeof(trace_record))
+    {
+        fclose(fp);
+        return 0;
+    }
+    while(fread(&rec,sizeof(rec),1,fp)==1) r.push_back(rec);
+    fclose(fp);
+    return 1;
+}
+
+//distance in units in the last place (0 for identical bits)
+static double ulp_distance(double a, double b)
+{
+    int64_t ia,ib;
+
+    if(isnan(a) || isnan(b)) return (isnan(a) && isnan(b)) ? 0.0 : INFINITY;
+    memcpy(&ia,&a,sizeof(ia));
+    memcpy(&ib,&b,sizeof(ib));
+    //map the sign-magnitude representation onto a monotonic integer scale
+    if(ia<0) ia=INT64_MIN-ia;
+    if(ib<0) ib=INT64_MIN-ib;
+    return (ia>ib) ? (double) ((uint64_t) ia-(uint64_t) ib) : (double) ((uint64_t) ib-(uint64_t) ia);
+}
+
+//deviation of a value from its golden value in the unit of the tolerance
+static double deviation(const tolerance &t, double golden, double value)
+{
+    if(t.mode==TOL_ULP) return ulp_distance(golden,value);
+    if(t.mode==TOL_ABS) return fabs(value-golden);
+    if(golden==value) return 0.0;
+    return fabs(value-golden)/fabs(golden);
+}
+
+static void default_tolerances(const char *engine, tolerance tol[])
+{
+    //the reference engine has to reproduce the golden file bit by bit
+    for(int q=0;q<Q_NUM;q++) {tol[q].mode=TOL_ULP; tol[q].value=0.0;}
+    tol[Q_ICONV].mode=TOL_ABS;
+    if(strcmp(engine,"double")==0) return;
+
+    //reduced precision engines: about ten times the deviations observed on
+    //the data sets of the golden file. the variance of the means is a small
+    //difference of large sums and suffers most from the fixed-point scaling
+    tol[Q_MEAN]={TOL_REL,1.0e-5};
+    tol[Q_MEANMEAN]={TOL_REL,1.0e-5};
+    tol[Q_OFFSET]={TOL_REL,1.0e-5};
+    tol[Q_VAR]={TOL_REL,1.0e-2};
+    tol[Q_VARMEAN]={TOL_REL,(strcmp(engine,"fixed")==0) ? 0.5 : 1.0e-2};
+    tol[Q_PROB]={TOL_ABS,1.0e-3};
+    tol[Q_ICONV]={TOL_ABS,2.0};
+}
+
+int main(int argc, char *argv[])
+{
+    vector<trace_record> golden,cand;
+    const char *engine="double";
+    tolerance tol[Q_NUM];
+    double maxdev[Q_NUM];
+    long count[Q_NUM];
+    int failed=0,k;
+
+    if(argc<3 || (strcmp(argv[1],"record")!=0 && strcmp(argv[1],"check")!=0))
+    {
+        printf("usage: %s record <golden file>\n",argv[0]);
+        printf("       %s check <golden file> [double|float|fixed] [--tol <quantity> <ulp|rel|abs> <value>]...\n",argv[0]);
+        return 1;
+    }
+
+    if(strcmp(argv[1],"record")==0)
+    {
+        if(collect(cand,"double")==0) return 1;
+        if(write_golden(argv[2],cand)==0)
+        {
+            printf("could not write file: %s\n",argv[2]);
+            return 1;
+        }
+        printf("%lu golden records written to %s\n",(unsigned long) cand.size(),argv[2]);
+        return 0;
+    }
+
+    k=3;
+    if(k<argc && strncmp(argv[k],"--",2)!=0) engine=argv[k++];
+    if(unique_ptr<oracle_engine>(make_engine(engine))==nullptr)
+    {
+        printf("unknown engine: %s\n",engine);
+        return 1;
+    }
+    default_tolerances(engine,tol);
+    for(;k+3<argc && strcmp(argv[k],"--tol")==0;k+=4)
+    {
+        int q;
+        for(q=0;q<Q_NUM && strcmp(argv[k+1],qname[q])!=0;q++);
+        if(q==Q_NUM) {printf("unknown quantity: %s\n",argv[k+1]); return 1;}
+        tol[q].mode=(strcmp(argv[k+2],"rel")==0) ? TOL_REL : ((strcmp(argv[k+2],"abs")==0) ? TOL_ABS : TOL_ULP);
+        tol[q].value=atof(argv[k+3]);
+    }
+
+    if(read_golden(argv[2],golden)==0)
+    {
+        printf("could not read golden file: %s\n",argv[2]);
+        return 1;
+    }
+    if(collect(cand,engine)==0) return 1;
+    if(cand.size()!=golden.size())
+    {
+        printf("FAILED: %lu records expected, %lu collected\n",(unsigned long) golden.size(),(unsigned long) cand.size());
+        return 1;
+    }
+
+    for(int q=0;q<Q_NUM;q++) {maxdev[q]=0.0; count[q]=0;}
+    for(size_t r=0;r<golden.size();r++)
+    {
+        const trace_record &g=golden[r],&c=cand[r];
+        double d;
+
+        if(g.series!=c.series || g.axis!=c.axis || (g.series!=ORACLE_RESULT && g.i!=c.i))
+        {
+            printf("FAILED: record %lu does not match (series %u axis %u i %u)\n",(unsigned long) r,
+                   (unsigned) g.series,(unsigned) g.axis,g.i);
+            return 1;
+        }
+        if(g.series==ORACLE_RNG || g.series==ORACLE_DATA_GYRO || g.series==ORACLE_DATA_ACC)
+        {
+            int q=(g.series==ORACLE_RNG) ? Q_RNG : Q_DATA;
+            maxdev[q]=fmax(maxdev[q],deviation(tol[q],g.stat[0],c.stat[0]));
+            count[q]++;
+        }
+        else if(g.series==ORACLE_RESULT)
+        {
+            d=fabs((double) g.i-(double) c.i);
+            maxdev[Q_ICONV]=fmax(maxdev[Q_ICONV],d);
+            count[Q_ICONV]++;
+            //offsets at convergence only if both converged at all
+            if(g.i!=0 && c.i!=0) maxdev[Q_OFFSET]=fmax(maxdev[Q_OFFSET],deviation(tol[Q_OFFSET],g.stat[0],c.stat[0]));
+            maxdev[Q_OFFSET]=fmax(maxdev[Q_OFFSET],deviation(tol[Q_OFFSET],g.stat[1],c.stat[1]));
+            maxdev[Q_STATIC]=fmax(maxdev[Q_STATIC],deviation(tol[Q_STATIC],g.stat[2],c.stat[2]));
+            count[Q_OFFSET]++;
+            count[Q_STATIC]++;
+        }
+        else
+        {
+            for(int j=0;j<4;j++)
+            {
+                maxdev[Q_MEAN+j]=fmax(maxdev[Q_MEAN+j],deviation(tol[Q_MEAN+j],g.stat[j],c.stat[j]));
+                count[Q_MEAN+j]++;
+            }
+            maxdev[Q_PROB]=fmax(maxdev[Q_PROB],deviation(tol[Q_PROB],g.prob,c.prob));
+            count[Q_PROB]++;
+        }
+    }
+
+    printf("engine %s against %s (%lu records):\n",engine,argv[2],(unsigned long) golden.size());
+    for(int q=0;q<Q_NUM;q++)
+    {
+        const char *unit=(tol[q].mode==TOL_ULP) ? "ulp" : ((tol[q].mode==TOL_REL) ? "rel" : "abs");
+        bool ok=(maxdev[q]<=tol[q].value);
+        if(!ok) failed++;
+        printf("  %-17s %6ld values  max deviation %-12g tolerance %-10g %s  %s\n",qname[q],count[q],maxdev[q],
+               tol[q].value,unit,ok ? "ok" : "FAILED");
+    }
+    printf("%s\n",(failed==0) ? "PASSED" : "FAILED");
+
+    return (failed==0) ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+//
+// Created by stefan on 11.05.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_PARALLEL_H
+#define PUBLICATION_RECURSIVE_MEAN_PARALLEL_H
+
+#include <vector>
+#include <thread>
+using namespace std;
+
+///******************************************************************
+// fork-join helpers shared by the parallel loaders and reductions
+// (expdata) and the bootstrap: the work items are distributed
+// round-robin by the jobs themselves
+//*******************************************************************
+
+//number of threads to be used for n work items (at least 1);
+//nthreads<=0 selects the hardware concurrency
+inline int worker_count(int nthreads, long n)
+{
+    int nt=(nthreads>0) ? nthreads : (int) thread::hardware_concurrency();
+
+    if(nt<1) nt=1;
+    if(nt>n) nt=(n>0) ? (int) n : 1;
+    return nt;
+}
+
+//runs job(0..nt-1) on nt threads, job 0 on the calling thread
+template <class F>
+void run_parallel(int nt, F job)
+{
+    vector<thread> workers;
+
+    for(int r=1;r<nt;r++) workers.emplace_back(job,r);
+    job(0);
+    for(auto &w : workers) w.join();
+}
+
+#endif //PUBLICATION_RECURSIVE_MEAN_PARALLEL_H
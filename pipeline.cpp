@@ -0,0 +1,229 @@
+//
+// Created by stefan on 16.03.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "pipeline.h"
+#include "metrics.h"
+#include "rgcodec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <atomic>
+
+void pipeline::parse_block(const string &text, vector<expdata::dynamic> &out)
+///******************************************************************
+/// PARSE_BLOCK
+/// -----------------------------------------------------------------
+/// parses the lines "t x y z" of the text block into samples which
+/// are appended to out, by the rule of expdata::read_file (blank
+/// lines are skipped, missing values are set to 0)
+/// -----------------------------------------------------------------
+/// text  - IN : text consisting of complete lines
+/// out   - OUT: samples
+/// -----------------------------------------------------------------
+{
+    const char *p=text.c_str(),*end=p+text.size(),*eol;
+    expdata::dynamic s;
+
+    while(p<end)
+    {
+        eol=(const char *) memchr(p,'\n',end-p);
+        if(eol==NULL) eol=end;
+        if(expdata::is_sample_line(p,eol))
+        {
+            expdata::parse_line(p,eol,s);
+            out.push_back(s);
+        }
+        p=eol+1;
+    }
+}
+
+int pipeline::decode_blocks(const string &data, uint32_t max_count, vector<expdata::dynamic> &out)
+///******************************************************************
+/// DECODE_BLOCKS
+/// -----------------------------------------------------------------
+/// decodes the complete rgcodec blocks of data into samples which
+/// are appended to out. returns 1 on success and 0 at the first
+/// corrupt block or block of more than max_count samples
+/// -----------------------------------------------------------------
+/// data      - IN : consecutive codec blocks
+/// max_count - IN : block size of the file header (samples)
+/// out       - OUT: samples
+/// -----------------------------------------------------------------
+{
+    const uint8_t *p=(const uint8_t *) data.data();
+    size_t pos=0,size=data.size();
+    vector<double> col[4];
+    expdata::dynamic s;
+    int n;
+
+    while(pos<size)
+    {
+        n=rgcodec::decode_block(p+pos,size-pos,col);
+        if(n<0 || (uint32_t) n>max_count) return 0;
+        for(int i=0;i<n;i++)
+        {
+            s.t=col[0][i]; s.x=col[1][i]; s.y=col[2][i]; s.z=col[3][i];
+            out.push_back(s);
+        }
+        pos+=rgcodec::block_size(p+pos);
+    }
+    return 1;
+}
+
+int pipeline::run(const char *fname, const function<bool(const expdata::dynamic *, int)> &consume)
+///******************************************************************
+/// RUN
+/// -----------------------------------------------------------------
+/// runs the pipeline on the file fname (text or compressed by
+/// rgcodec as given by format, then the parser stage decodes). consume is called for each
+/// block of samples in order and returns false to stop early, which
+/// cancels the upstream stages. the header and every block of a
+/// compressed file are checked before they are allocated. returns 1
+/// on success and 0 if the file could not be opened or is corrupt
+/// (corrupt is set, the consumer may have seen the samples before)
+/// -----------------------------------------------------------------
+/// fname   - IN: name of the data file
+/// consume - IN: consumer of the sample blocks
+/// -----------------------------------------------------------------
+{
+    FILE *fp;
+    blockqueue<string> raw(queue_blocks);
+    blockqueue<vector<expdata::dynamic> > parsed(queue_blocks);
+    vector<expdata::dynamic> block;
+    atomic<bool> cancel(false),failed(false);
+    bool compressed;
+    uint32_t head[4]={0,0,0,0};
+    size_t max_bytes=0;
+    uint64_t t0;
+
+    compressed=(format==EXPDATA_INPUT_AUTO) ? (rgcodec::is_compressed(fname)==1) : (format==EXPDATA_INPUT_RGC);
+    fp=fopen(fname,"rb");
+    if(fp==NULL) return 0;
+    busy_read=busy_parse=busy_consume=0.0;
+    samples=0;
+    corrupt=false;
+    //compressed files: the header bounds the size of every block
+    if(compressed)
+    {
+        if(fread(head,sizeof(head),1,fp)!=1 || rgcodec::check_header(head)==0)
+        {
+            fclose(fp);
+            corrupt=true;
+            return 0;
+        }
+        max_bytes=rgcodec::max_block_bytes(head[2]);
+    }
+
+    //stage 1: raw blocks cut after the last complete line
+    thread reader([&]()
+    {
+        string carry;
+        size_t n,got,cut;
+        bool eof;
+        while(!compressed && !cancel.load(memory_order_relaxed))
+        {
+            uint64_t ts=metrics::now();
+            string buf(move(carry));
+            carry=string();
+            n=buf.size();
+            buf.resize(n+read_block);
+            got=fread(&buf[n],1,read_block,fp);
+            buf.resize(n+got);
+            eof=(got<read_block);
+            //the incomplete last line is carried over into the next block
+            if(!eof)
+            {
+                cut=buf.rfind('\n');
+                if(cut==string::npos) {carry.swap(buf); continue;}
+                carry.assign(buf,cut+1,string::npos);
+                buf.resize(cut+1);
+            }
+            busy_read+=1.0e-9*(metrics::now()-ts);
+            if(!buf.empty() && raw.push(move(buf))==0) break;
+            if(eof) break;
+        }
+        //compressed files: whole codec blocks (behind the file header) are collected,
+        //a block larger than the header allows or cut off is not allocated resp. passed on
+        eof=false;
+        while(compressed && !eof && !failed.load() && !cancel.load(memory_order_relaxed))
+        {
+            uint64_t ts=metrics::now();
+            uint32_t size;
+            string buf;
+            while(buf.size()<read_block)
+            {
+                if(fread(&size,sizeof(size),1,fp)!=1) {eof=true; break;}
+                if(sizeof(size)+(size_t) size>max_bytes) {failed.store(true); break;}
+                n=buf.size();
+                buf.resize(n+sizeof(size)+size);
+                memcpy(&buf[n],&size,sizeof(size));
+                got=fread(&buf[n+sizeof(size)],1,size,fp);
+                if(got<size) {buf.resize(n); failed.store(true); break;}
+            }
+            busy_read+=1.0e-9*(metrics::now()-ts);
+            if(!buf.empty() && raw.push(move(buf))==0) break;
+        }
+        raw.close();
+    });
+
+    //stage 2: parsing
+    thread parser([&]()
+    {
+        string text;
+        while(raw.pop(text))
+        {
+            uint64_t ts=metrics::now();
+            vector<expdata::dynamic> out;
+            if(compressed)
+            {
+                if(decode_blocks(text,head[2],out)==0) failed.store(true);
+            }
+            else
+            {
+                out.reserve(text.size()/48+1);
+                parse_block(text,out);
+            }
+            busy_parse+=1.0e-9*(metrics::now()-ts);
+            if(parsed.push(move(out))==0) break;
+            //a corrupt block stops the reader as well
+            if(failed.load()) {raw.close(); break;}
+        }
+        parsed.close();
+    });
+
+    //stage 3: consumer on the calling thread
+    while(parsed.pop(block))
+    {
+        t0=metrics::now();
+        samples+=(long) block.size();
+        bool more=consume(block.data(),(int) block.size());
+        busy_consume+=1.0e-9*(metrics::now()-t0);
+        if(!more)
+        {
+            //cancel the upstream stages and unblock them
+            cancel.store(true);
+            raw.close();
+            parsed.close();
+            break;
+        }
+    }
+
+    reader.join();
+    parser.join();
+    fclose(fp);
+    corrupt=failed.load();
+    return corrupt ? 0 : 1;
+}
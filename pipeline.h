@@ -0,0 +1,149 @@
+//
+// Created by stefan on 16.03.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_PIPELINE_H
+#define PUBLICATION_RECURSIVE_MEAN_PIPELINE_H
+
+#include "expdata.h"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <string>
+#include <vector>
+using namespace std;
+
+//*******************************************************************
+// bounded blocking queue between two pipeline stages: push blocks
+// while the queue is full (backpressure), pop blocks while it is
+// empty. After close() push discards and pop returns 0 once empty.
+//*******************************************************************
+
+template <class T>
+class blockqueue {
+
+private:
+
+    deque<T> items;
+    size_t capacity;
+    bool closed=false;
+    mutex lock;
+    condition_variable not_full,not_empty;
+
+public:
+
+    explicit blockqueue(size_t cap) : capacity(cap) {}
+
+    int push(T &&item)
+    {
+        unique_lock<mutex> guard(lock);
+        not_full.wait(guard,[this]{return closed || items.size()<capacity;});
+        if(closed) return 0;
+        items.push_back(move(item));
+        not_empty.notify_one();
+        return 1;
+    }
+
+    int pop(T &item)
+    {
+        unique_lock<mutex> guard(lock);
+        not_empty.wait(guard,[this]{return closed || !items.empty();});
+        if(items.empty()) return 0;
+        item=move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return 1;
+    }
+
+    void close()
+    {
+        lock_guard<mutex> guard(lock);
+        closed=true;
+        not_full.notify_all();
+        not_empty.notify_all();
+    }
+
+};
+
+//*******************************************************************
+// pipelined ingestion of a data file of the format "t x y z": a reader
+// thread reads raw blocks cut at line boundaries, a parser thread turns
+// them into blocks of samples and the calling thread hands the blocks
+// to the consumer (e.g. the recursion). The stages are connected by
+// bounded queues, so I/O, parsing and statistics overlap and the wall
+// clock time approaches the time of the slowest stage.
+//*******************************************************************
+
+class pipeline {
+
+public:
+
+    size_t read_block=1<<20;   //bytes per raw block
+    size_t queue_blocks=8;     //capacity of each queue in blocks
+
+    double busy_read=0.0;      //busy time of the stages in seconds
+    double busy_parse=0.0;
+    double busy_consume=0.0;
+    long samples=0;            //number of samples handed to the consumer
+    bool corrupt=false;        //set by run if the compressed file is corrupt
+    int format=EXPDATA_INPUT_AUTO; //format of the data file (EXPDATA_INPUT_*)
+
+    ///******************************************************************
+    /// RUN
+    /// -----------------------------------------------------------------
+    /// runs the pipeline on the file fname (text or compressed by
+    /// rgcodec as given by format, then the parser stage decodes). consume is called for each
+    /// block of samples in order and returns false to stop early, which
+    /// cancels the upstream stages. the header and every block of a
+    /// compressed file are checked before they are allocated. returns 1
+    /// on success and 0 if the file could not be opened or is corrupt
+    /// (corrupt is set, the consumer may have seen the samples before)
+    /// -----------------------------------------------------------------
+    /// fname   - IN: name of the data file
+    /// consume - IN: consumer of the sample blocks
+    /// -----------------------------------------------------------------
+
+    int run(const char *fname, const function<bool(const expdata::dynamic *, int)> &consume);
+
+    ///******************************************************************
+    /// PARSE_BLOCK
+    /// -----------------------------------------------------------------
+    /// parses the lines "t x y z" of the text block into samples which
+    /// are appended to out, by the rule of expdata::read_file (blank
+    /// lines are skipped, missing values are set to 0)
+    /// -----------------------------------------------------------------
+    /// text  - IN : text consisting of complete lines
+    /// out   - OUT: samples
+    /// -----------------------------------------------------------------
+
+    static void parse_block(const string &text, vector<expdata::dynamic> &out);
+
+    ///******************************************************************
+    /// DECODE_BLOCKS
+    /// -----------------------------------------------------------------
+    /// decodes the complete rgcodec blocks of data into samples which
+    /// are appended to out. returns 1 on success and 0 at the first
+    /// corrupt block or block of more than max_count samples
+    /// -----------------------------------------------------------------
+    /// data      - IN : consecutive codec blocks
+    /// max_count - IN : block size of the file header (samples)
+    /// out       - OUT: samples
+    /// -----------------------------------------------------------------
+
+    static int decode_blocks(const string &data, uint32_t max_count, vector<expdata::dynamic> &out);
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_PIPELINE_H
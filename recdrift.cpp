@@ -0,0 +1,198 @@
+//
+// Created by stefan on 04.05.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "recdrift.h"
+#include <math.h>
+
+recdrift::recdrift()
+{
+    reset();
+}
+
+void recdrift::reset()
+///******************************************************************
+/// RESET
+/// -----------------------------------------------------------------
+/// discards all samples
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+{
+    n=0;
+    t0=tlast=mt=stt=0.0;
+    for(int j=0;j<3;j++)
+    {
+        my[j]=sty[j]=syy[j]=0.0;
+        for(int k=0;k<RECSTAT_LONG_SIZE;k++) cst[j][k]=0.0;
+    }
+}
+
+void recdrift::update(const expdata::dynamic &s)
+///******************************************************************
+/// UPDATE
+/// -----------------------------------------------------------------
+/// adds the time stamped sample s to the fit of the three components
+/// -----------------------------------------------------------------
+/// s     - IN: sample (t,x,y,z)
+/// -----------------------------------------------------------------
+{
+    double y[3]={s.x,s.y,s.z},dt,dt2,inv,dy;
+    recstat rs;
+
+    if(n==0) t0=s.t;
+    n++;
+    inv=1.0/(double) n;
+    tlast=s.t-t0;
+    //time terms shared by the components
+    dt=tlast-mt;
+    mt+=dt*inv;
+    dt2=tlast-mt;
+    stt+=dt*dt2;
+    //co-moments of the components (independent, vectorizable)
+    for(int j=0;j<3;j++)
+    {
+        dy=y[j]-my[j];
+        my[j]+=dy*inv;
+        sty[j]+=dt*(y[j]-my[j]);
+        syy[j]+=dy*(y[j]-my[j]);
+    }
+    for(int j=0;j<3;j++) rs.seq_update_long(cst[j],y[j],n);
+}
+
+void recdrift::update_block(const expdata::dynamic s[], int m)
+///******************************************************************
+/// UPDATE_BLOCK
+/// -----------------------------------------------------------------
+/// adds the samples s[0..m-1] in order
+/// -----------------------------------------------------------------
+/// s     - IN: samples
+/// m     - IN: number of samples
+/// -----------------------------------------------------------------
+{
+    for(int k=0;k<m;k++) update(s[k]);
+}
+
+double recdrift::drift(int j) const
+///******************************************************************
+/// DRIFT
+/// -----------------------------------------------------------------
+/// returns the fitted drift of component j per unit of time (0 as
+/// long as all time stamps are equal)
+/// -----------------------------------------------------------------
+/// j     - IN: component (0..2)
+/// -----------------------------------------------------------------
+{
+    return (stt>0.0) ? sty[j]/stt : 0.0;
+}
+
+double recdrift::offset_at(int j, double t) const
+///******************************************************************
+/// OFFSET_AT
+/// -----------------------------------------------------------------
+/// returns the fitted offset of component j at the time stamp t,
+/// e.g. the current bias for the time stamp of the last sample
+/// -----------------------------------------------------------------
+/// j     - IN: component (0..2)
+/// t     - IN: time stamp
+/// -----------------------------------------------------------------
+{
+    return my[j]+drift(j)*(t-t0-mt);
+}
+
+//residual variance s^2 of the fit of component j (n>=3, stt>0)
+double recdrift::residual_variance(int j) const
+{
+    double rss=syy[j]-sty[j]*sty[j]/stt;
+
+    return ((rss>0.0) ? rss : 0.0)/(double) (n-2);
+}
+
+double recdrift::offset_variance(int j, double t) const
+///******************************************************************
+/// OFFSET_VARIANCE
+/// -----------------------------------------------------------------
+/// returns the variance of the offset of component j at the time
+/// stamp t, s^2*(1/n+(t-tc)^2/S_tt), or -1 for less than 3 samples
+/// -----------------------------------------------------------------
+/// j     - IN: component (0..2)
+/// t     - IN: time stamp
+/// -----------------------------------------------------------------
+{
+    double d;
+
+    if(n<3) return -1.0;
+    //without spread in time only the constant offset can be fitted
+    if(stt<=0.0) return syy[j]/((double) (n-1)*(double) n);
+    d=t-t0-mt;
+    return residual_variance(j)*(1.0/(double) n+d*d/stt);
+}
+
+bool recdrift::drift_used(int j) const
+///******************************************************************
+/// DRIFT_USED
+/// -----------------------------------------------------------------
+/// returns true if the drift term of component j is used, i.e. the
+/// time stamps span min_span and |drift| > drift_z*sd(drift) with
+/// var(drift)=s^2/S_tt
+/// -----------------------------------------------------------------
+/// j     - IN: component (0..2)
+/// -----------------------------------------------------------------
+{
+    double b;
+
+    if(n<3 || stt<=0.0 || tlast<min_span) return false;
+    b=sty[j]/stt;
+    return b*b>drift_z*drift_z*residual_variance(j)/stt;
+}
+
+double recdrift::estimate(int j) const
+///******************************************************************
+/// ESTIMATE
+/// -----------------------------------------------------------------
+/// returns the current bias of component j: the offset at the time
+/// stamp of the last sample if the drift term is used, otherwise the
+/// mean of means of the constant model
+/// -----------------------------------------------------------------
+/// j     - IN: component (0..2)
+/// -----------------------------------------------------------------
+{
+    return drift_used(j) ? offset_at(j,t0+tlast) : cst[j][2];
+}
+
+double recdrift::accept_probability(int j, double f) const
+///******************************************************************
+/// ACCEPT_PROBABILITY
+/// -----------------------------------------------------------------
+/// acceptance probability of the estimate of component j for the
+/// fractional accuracy f: of the bias at the last sample, 0 for
+/// less than 3 samples, or that of recstat for the constant model
+/// -----------------------------------------------------------------
+/// j     - IN: component (0..2)
+/// f     - IN: required fractional accuracy
+/// -----------------------------------------------------------------
+{
+    double v,stat[RECSTAT_LONG_SIZE];
+    recstat rs;
+
+    if(!drift_used(j))
+    {
+        //seq_accept_probability takes a writable array
+        for(int k=0;k<RECSTAT_LONG_SIZE;k++) stat[k]=cst[j][k];
+        return rs.seq_accept_probability(stat,f);
+    }
+    v=offset_variance(j,t0+tlast);
+    if(v==0.0) return 1.0;
+    return erf(f*fabs(offset_at(j,t0+tlast))/sqrt(2.0*v));
+}
@@ -0,0 +1,188 @@
+//
+// Created by stefan on 04.05.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_RECDRIFT_H
+#define PUBLICATION_RECURSIVE_MEAN_RECDRIFT_H
+
+#include "expdata.h"
+#include "recstats.h"
+#include <stdint.h>
+
+//*******************************************************************
+// offset plus linear drift: for every component the model
+//     y(t) = offset + drift*(t-tc)
+// is fitted by recursive least squares over the time stamped samples,
+// where tc is the mean of the time stamps (at tc the errors of offset
+// and drift are uncorrelated). The recursion keeps the means of t and
+// y and the centered co-moments S_tt, S_ty, S_yy (welford), which is
+// least squares without forgetting in O(1) per sample; t and the three
+// components share the time terms, and the component updates run over
+// contiguous arrays which the compiler maps onto vector instructions.
+// The estimate is the current bias, i.e. the offset at the time stamp
+// of the last sample, with the variance s^2*(1/n+(t-tc)^2/S_tt) and
+// the residual variance s^2=(S_yy-S_ty^2/S_tt)/(n-2). Its acceptance
+// probability is the one of recstat, erf(f*|est|/sqrt(2*var(est))).
+// A slowly ramping bias then ends up in the drift term instead of
+// inflating the variance. A short window cannot tell a drift from
+// correlated noise, hence the drift term is only used once the time
+// stamps span min_span and the drift differs from 0 by drift_z
+// standard deviations; otherwise the constant model of recstat (the
+// mean of means of seq_update_long and its test) is used, which the
+// recursion keeps alongside.
+//*******************************************************************
+
+class recdrift {
+
+private:
+
+    int64_t n=0;              //number of samples
+    double t0=0.0;            //time stamp of the first sample (origin of t)
+    double tlast=0.0;         //time stamp of the last sample (relative to t0)
+    double mt=0.0;            //mean of the time stamps (relative to t0)
+    double stt=0.0;           //sum of (t-mt)^2
+    double my[3];             //means of the components
+    double sty[3];            //sums of (t-mt)*(y-my)
+    double syy[3];            //sums of (y-my)^2
+    double cst[3][RECSTAT_LONG_SIZE]; //constant model (recstat::seq_update_long)
+
+    double residual_variance(int j) const;
+
+public:
+
+    double min_span=10.0;     //minimum time span of the samples for the drift term
+    double drift_z=3.0;       //significance of the drift term in standard deviations
+
+    recdrift();
+
+    ///******************************************************************
+    /// RESET
+    /// -----------------------------------------------------------------
+    /// discards all samples
+    /// -----------------------------------------------------------------
+    /// no input arguments
+    /// -----------------------------------------------------------------
+
+    void reset();
+
+    ///******************************************************************
+    /// UPDATE
+    /// -----------------------------------------------------------------
+    /// adds the time stamped sample s to the fit of the three components
+    /// -----------------------------------------------------------------
+    /// s     - IN: sample (t,x,y,z)
+    /// -----------------------------------------------------------------
+
+    void update(const expdata::dynamic &s);
+
+    ///******************************************************************
+    /// UPDATE_BLOCK
+    /// -----------------------------------------------------------------
+    /// adds the samples s[0..m-1] in order
+    /// -----------------------------------------------------------------
+    /// s     - IN: samples
+    /// m     - IN: number of samples
+    /// -----------------------------------------------------------------
+
+    void update_block(const expdata::dynamic s[], int m);
+
+    ///******************************************************************
+    /// OFFSET
+    /// -----------------------------------------------------------------
+    /// returns the fitted offset of component j at the mean time tc
+    /// -----------------------------------------------------------------
+    /// j     - IN: component (0..2)
+    /// -----------------------------------------------------------------
+
+    double offset(int j) const {return my[j];}
+
+    ///******************************************************************
+    /// DRIFT
+    /// -----------------------------------------------------------------
+    /// returns the fitted drift of component j per unit of time (0 as
+    /// long as all time stamps are equal)
+    /// -----------------------------------------------------------------
+    /// j     - IN: component (0..2)
+    /// -----------------------------------------------------------------
+
+    double drift(int j) const;
+
+    ///******************************************************************
+    /// OFFSET_AT
+    /// -----------------------------------------------------------------
+    /// returns the fitted offset of component j at the time stamp t,
+    /// e.g. the current bias for the time stamp of the last sample
+    /// -----------------------------------------------------------------
+    /// j     - IN: component (0..2)
+    /// t     - IN: time stamp
+    /// -----------------------------------------------------------------
+
+    double offset_at(int j, double t) const;
+
+    ///******************************************************************
+    /// OFFSET_VARIANCE
+    /// -----------------------------------------------------------------
+    /// returns the variance of the offset of component j at the time
+    /// stamp t, s^2*(1/n+(t-tc)^2/S_tt), or -1 for less than 3 samples
+    /// -----------------------------------------------------------------
+    /// j     - IN: component (0..2)
+    /// t     - IN: time stamp
+    /// -----------------------------------------------------------------
+
+    double offset_variance(int j, double t) const;
+
+    ///******************************************************************
+    /// DRIFT_USED
+    /// -----------------------------------------------------------------
+    /// returns true if the drift term of component j is used, i.e. the
+    /// time stamps span min_span and |drift| > drift_z*sd(drift) with
+    /// var(drift)=s^2/S_tt
+    /// -----------------------------------------------------------------
+    /// j     - IN: component (0..2)
+    /// -----------------------------------------------------------------
+
+    bool drift_used(int j) const;
+
+    ///******************************************************************
+    /// ESTIMATE
+    /// -----------------------------------------------------------------
+    /// returns the current bias of component j: the offset at the time
+    /// stamp of the last sample if the drift term is used, otherwise the
+    /// mean of means of the constant model
+    /// -----------------------------------------------------------------
+    /// j     - IN: component (0..2)
+    /// -----------------------------------------------------------------
+
+    double estimate(int j) const;
+
+    ///******************************************************************
+    /// ACCEPT_PROBABILITY
+    /// -----------------------------------------------------------------
+    /// acceptance probability of the estimate of component j for the
+    /// fractional accuracy f: of the bias at the last sample, 0 for
+    /// less than 3 samples, or that of recstat for the constant model
+    /// -----------------------------------------------------------------
+    /// j     - IN: component (0..2)
+    /// f     - IN: required fractional accuracy
+    /// -----------------------------------------------------------------
+
+    double accept_probability(int j, double f) const;
+
+    double mean_time() const {return t0+mt;}
+    double last_time() const {return t0+tlast;}
+    int64_t samples() const {return n;}
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_RECDRIFT_H
@@ -0,0 +1,274 @@
+//
+// Created by stefan on 27.04.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "recgyro.h"
+#include "calibrator.h"
+#include "expdata.h"
+#include <new>
+#include <stddef.h>
+#include <string.h>
+
+//the opaque handle of the C interface
+struct recgyro_calibrator
+{
+    calibrator cal;
+};
+
+//size of the configuration of version 3, the first with struct_size
+static const uint32_t config_size_v3=(uint32_t) (offsetof(recgyro_config,long_horizon)+sizeof(int));
+
+void recgyro_default_config(recgyro_config *cfg)
+///******************************************************************
+/// RECGYRO_DEFAULT_CONFIG
+/// -----------------------------------------------------------------
+/// fills cfg with the operating point of the publication and sets
+/// struct_size, hence a configuration has to start from it
+/// -----------------------------------------------------------------
+/// cfg   - OUT: configuration
+/// -----------------------------------------------------------------
+{
+    if(cfg==nullptr) return;
+    cfg->struct_size=(uint32_t) sizeof(recgyro_config);
+    cfg->prop=0.9;
+    cfg->fractional=0.005;
+    cfg->min_runs=100;
+    cfg->robust_c=0.0;
+    cfg->long_horizon=0;
+}
+
+int recgyro_version(void)
+///******************************************************************
+/// RECGYRO_VERSION
+/// -----------------------------------------------------------------
+/// returns RECGYRO_API_VERSION of the library, to be compared by the
+/// caller with the one of the header it was compiled against
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+{
+    return RECGYRO_API_VERSION;
+}
+
+int recgyro_create(const recgyro_config *cfg, recgyro_calibrator **cal)
+///******************************************************************
+/// RECGYRO_CREATE
+/// -----------------------------------------------------------------
+/// creates a calibrator (cfg may be NULL for the defaults). only the
+/// first struct_size bytes of cfg are read, members behind them keep
+/// their defaults; a struct_size below the one of version 3 or above
+/// the one of the library is rejected. returns 0 on success or
+/// RECGYRO_ERR_ARG resp. RECGYRO_ERR_ALLOC
+/// -----------------------------------------------------------------
+/// cfg   - IN : configuration
+/// cal   - OUT: new calibrator
+/// -----------------------------------------------------------------
+{
+    recgyro_calibrator *c;
+    recgyro_config full;
+
+    if(cal==nullptr) return RECGYRO_ERR_ARG;
+    *cal=nullptr;
+    if(cfg!=nullptr)
+    {
+        if(cfg->struct_size<config_size_v3 || cfg->struct_size>sizeof(recgyro_config)) return RECGYRO_ERR_ARG;
+        recgyro_default_config(&full);
+        memcpy(&full,cfg,cfg->struct_size);
+        full.struct_size=(uint32_t) sizeof(recgyro_config);
+    }
+    c=new(nothrow) recgyro_calibrator;
+    if(c==nullptr) return RECGYRO_ERR_ALLOC;
+    if(cfg!=nullptr && c->cal.configure(full)!=0)
+    {
+        delete c;
+        return RECGYRO_ERR_ARG;
+    }
+    *cal=c;
+    return 0;
+}
+
+void recgyro_destroy(recgyro_calibrator *cal)
+///******************************************************************
+/// RECGYRO_DESTROY
+/// -----------------------------------------------------------------
+/// releases the calibrator (NULL is ignored)
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// -----------------------------------------------------------------
+{
+    delete cal;
+}
+
+int recgyro_set_callbacks(recgyro_calibrator *cal, recgyro_axis_callback axis, recgyro_done_callback done, void *user)
+///******************************************************************
+/// RECGYRO_SET_CALLBACKS
+/// -----------------------------------------------------------------
+/// installs the callbacks (each may be NULL) and their user pointer.
+/// returns 0 or RECGYRO_ERR_ARG
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// axis  - IN: called once per component on its convergence
+/// done  - IN: called once when all components have converged
+/// user  - IN: passed through to the callbacks
+/// -----------------------------------------------------------------
+{
+    if(cal==nullptr) return RECGYRO_ERR_ARG;
+    cal->cal.set_callbacks(axis,done,user);
+    return 0;
+}
+
+int recgyro_push(recgyro_calibrator *cal, double x, double y, double z)
+///******************************************************************
+/// RECGYRO_PUSH
+/// -----------------------------------------------------------------
+/// feeds one sample into the recursion. returns RECGYRO_RUNNING,
+/// RECGYRO_CONVERGED (further samples are ignored) or an error code;
+/// without long_horizon RECGYRO_ERR_OVERFLOW once 2^31-1 samples are
+/// in the recursion (the count of recstat::seq_update is an int)
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// x,y,z - IN: gyroscopic sample
+/// -----------------------------------------------------------------
+{
+    double s[3]={x,y,z};
+
+    if(cal==nullptr) return RECGYRO_ERR_ARG;
+    return cal->cal.push(s);
+}
+
+int recgyro_push_block(recgyro_calibrator *cal, const double *xyz, int n)
+///******************************************************************
+/// RECGYRO_PUSH_BLOCK
+/// -----------------------------------------------------------------
+/// feeds n samples stored as x,y,z triples; stops at convergence or
+/// at the first sample which is not finite. returns as recgyro_push
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// xyz   - IN: samples (3*n values)
+/// n     - IN: number of samples
+/// -----------------------------------------------------------------
+{
+    if(cal==nullptr || n<0 || (xyz==nullptr && n>0)) return RECGYRO_ERR_ARG;
+    return cal->cal.push_block(xyz,n);
+}
+
+int recgyro_push_file(recgyro_calibrator *cal, const char *fname)
+///******************************************************************
+/// RECGYRO_PUSH_FILE
+/// -----------------------------------------------------------------
+/// feeds the samples of a data file ("t x y z" text or compressed by
+/// rgcodec) until convergence. allocates, hence not for the real-time
+/// path. returns as recgyro_push or RECGYRO_ERR_FILE
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// fname - IN: name of the data file
+/// -----------------------------------------------------------------
+{
+    samplestore store;
+    double buf[3*256];
+    int n,res=RECGYRO_RUNNING;
+
+    if(cal==nullptr || fname==nullptr) return RECGYRO_ERR_ARG;
+    try
+    {
+        n=expdata::read_file(fname,store);
+    }
+    catch(const bad_alloc &)
+    {
+        return RECGYRO_ERR_ALLOC;
+    }
+    catch(...)
+    {
+        //e.g. std::system_error of the decoding threads: nothing may
+        //escape through the C interface
+        return RECGYRO_ERR_FILE;
+    }
+    if(n<0) return RECGYRO_ERR_FILE;
+    for(int i0=0;i0<n && res==RECGYRO_RUNNING;i0+=256)
+    {
+        int m=(n-i0<256) ? n-i0 : 256;
+        for(int k=0;k<m;k++)
+        {
+            for(int j=0;j<3;j++) buf[3*k+j]=store.get(j,i0+k);
+        }
+        res=cal->cal.push_block(buf,m);
+    }
+    return res;
+}
+
+int recgyro_offsets(const recgyro_calibrator *cal, double offset[], double prob[])
+///******************************************************************
+/// RECGYRO_OFFSETS
+/// -----------------------------------------------------------------
+/// returns the current offset estimates and acceptance probabilities
+/// (prob may be NULL) together with the status as recgyro_push
+/// -----------------------------------------------------------------
+/// cal   - IN : calibrator
+/// offset- OUT: offsets of the three components
+/// prob  - OUT: acceptance probabilities of the three components
+/// -----------------------------------------------------------------
+{
+    if(cal==nullptr || offset==nullptr) return RECGYRO_ERR_ARG;
+    return cal->cal.offsets(offset,prob);
+}
+
+int64_t recgyro_samples(const recgyro_calibrator *cal)
+///******************************************************************
+/// RECGYRO_SAMPLES
+/// -----------------------------------------------------------------
+/// returns the number of samples in the recursion (or RECGYRO_ERR_ARG)
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// -----------------------------------------------------------------
+{
+    if(cal==nullptr) return RECGYRO_ERR_ARG;
+    return cal->cal.samples();
+}
+
+int recgyro_reset(recgyro_calibrator *cal)
+///******************************************************************
+/// RECGYRO_RESET
+/// -----------------------------------------------------------------
+/// restarts the calibration, configuration and callbacks are kept.
+/// returns 0 or RECGYRO_ERR_ARG
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// -----------------------------------------------------------------
+{
+    if(cal==nullptr) return RECGYRO_ERR_ARG;
+    cal->cal.reset();
+    return 0;
+}
+
+const char *recgyro_error_string(int code)
+///******************************************************************
+/// RECGYRO_ERROR_STRING
+/// -----------------------------------------------------------------
+/// returns a static description of the status or error code
+/// -----------------------------------------------------------------
+/// code  - IN: return code of a recgyro function
+/// -----------------------------------------------------------------
+{
+    switch(code)
+    {
+        case RECGYRO_RUNNING: return "running";
+        case RECGYRO_CONVERGED: return "converged";
+        case RECGYRO_ERR_ARG: return "invalid argument";
+        case RECGYRO_ERR_SAMPLE: return "sample not finite";
+        case RECGYRO_ERR_ALLOC: return "out of memory";
+        case RECGYRO_ERR_FILE: return "file could not be read";
+        case RECGYRO_ERR_OVERFLOW: return "sample count exceeds 2^31-1, use long_horizon";
+        default: return "unknown code";
+    }
+}
@@ -0,0 +1,218 @@
+//
+// Created by stefan on 27.04.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_RECGYRO_H
+#define PUBLICATION_RECURSIVE_MEAN_RECGYRO_H
+
+//*******************************************************************
+// C interface of the library librecgyro for embedding the calibration
+// into a driver or acquisition process: a calibrator is created with
+// a configuration, the gyroscopic samples are pushed one by one or in
+// blocks and callbacks report the convergence of every component and
+// the final offsets. Errors are reported by negative return codes, the
+// library never terminates the process. recgyro_push and
+// recgyro_push_block neither allocate nor lock nor print, hence they
+// may be called from a real-time acquisition loop; the callbacks are
+// invoked on the pushing thread and have to obey the same rules.
+//*******************************************************************
+
+#define RECGYRO_API_VERSION 3
+
+//status codes (>=0) and error codes (<0)
+#define RECGYRO_RUNNING 0             //not converged yet
+#define RECGYRO_CONVERGED 1           //all components converged, offsets final
+#define RECGYRO_ERR_ARG -1            //invalid argument (null pointer, bad configuration)
+#define RECGYRO_ERR_SAMPLE -2         //sample not finite, it was ignored
+#define RECGYRO_ERR_ALLOC -3          //out of memory
+#define RECGYRO_ERR_FILE -4           //file could not be read
+#define RECGYRO_ERR_OVERFLOW -5       //2^31-1 samples without long_horizon, sample ignored
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct recgyro_calibrator recgyro_calibrator;
+
+typedef struct recgyro_config
+{
+    uint32_t struct_size;             //sizeof(recgyro_config) of the caller, set by
+                                      //recgyro_default_config; members added later
+                                      //behind it keep their defaults for older callers
+    double prop;                      //acceptance probability (0,1), default 0.9
+    double fractional;                //fractional accuracy (>0), default 0.005
+    int min_runs;                     //minimum number of samples, default 100
+    double robust_c;                  //outlier gate in standard deviations (0: off)
+    int long_horizon;                 //1: 64-bit counts and compensated means (recstat::
+                                      //seq_update_long), required beyond 2^31 samples;
+                                      //not together with robust_c
+} recgyro_config;
+
+//convergence of component axis (0..2) after n samples
+typedef void (*recgyro_axis_callback)(void *user, int axis, int64_t n, double offset, double prob);
+//convergence of all components after n samples, offset[0..2]
+typedef void (*recgyro_done_callback)(void *user, int64_t n, const double offset[]);
+
+///******************************************************************
+/// RECGYRO_DEFAULT_CONFIG
+/// -----------------------------------------------------------------
+/// fills cfg with the operating point of the publication and sets
+/// struct_size, hence a configuration has to start from it
+/// -----------------------------------------------------------------
+/// cfg   - OUT: configuration
+/// -----------------------------------------------------------------
+
+void recgyro_default_config(recgyro_config *cfg);
+
+///******************************************************************
+/// RECGYRO_VERSION
+/// -----------------------------------------------------------------
+/// returns RECGYRO_API_VERSION of the library, to be compared by the
+/// caller with the one of the header it was compiled against
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+
+int recgyro_version(void);
+
+///******************************************************************
+/// RECGYRO_CREATE
+/// -----------------------------------------------------------------
+/// creates a calibrator (cfg may be NULL for the defaults). only the
+/// first struct_size bytes of cfg are read, members behind them keep
+/// their defaults; a struct_size below the one of version 3 or above
+/// the one of the library is rejected. returns 0 on success or
+/// RECGYRO_ERR_ARG resp. RECGYRO_ERR_ALLOC
+/// -----------------------------------------------------------------
+/// cfg   - IN : configuration
+/// cal   - OUT: new calibrator
+/// -----------------------------------------------------------------
+
+int recgyro_create(const recgyro_config *cfg, recgyro_calibrator **cal);
+
+///******************************************************************
+/// RECGYRO_DESTROY
+/// -----------------------------------------------------------------
+/// releases the calibrator (NULL is ignored)
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// -----------------------------------------------------------------
+
+void recgyro_destroy(recgyro_calibrator *cal);
+
+///******************************************************************
+/// RECGYRO_SET_CALLBACKS
+/// -----------------------------------------------------------------
+/// installs the callbacks (each may be NULL) and their user pointer.
+/// returns 0 or RECGYRO_ERR_ARG
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// axis  - IN: called once per component on its convergence
+/// done  - IN: called once when all components have converged
+/// user  - IN: passed through to the callbacks
+/// -----------------------------------------------------------------
+
+int recgyro_set_callbacks(recgyro_calibrator *cal, recgyro_axis_callback axis, recgyro_done_callback done, void *user);
+
+///******************************************************************
+/// RECGYRO_PUSH
+/// -----------------------------------------------------------------
+/// feeds one sample into the recursion. returns RECGYRO_RUNNING,
+/// RECGYRO_CONVERGED (further samples are ignored) or an error code;
+/// without long_horizon RECGYRO_ERR_OVERFLOW once 2^31-1 samples are
+/// in the recursion (the count of recstat::seq_update is an int)
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// x,y,z - IN: gyroscopic sample
+/// -----------------------------------------------------------------
+
+int recgyro_push(recgyro_calibrator *cal, double x, double y, double z);
+
+///******************************************************************
+/// RECGYRO_PUSH_BLOCK
+/// -----------------------------------------------------------------
+/// feeds n samples stored as x,y,z triples; stops at convergence or
+/// at the first sample which is not finite. returns as recgyro_push
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// xyz   - IN: samples (3*n values)
+/// n     - IN: number of samples
+/// -----------------------------------------------------------------
+
+int recgyro_push_block(recgyro_calibrator *cal, const double *xyz, int n);
+
+///******************************************************************
+/// RECGYRO_PUSH_FILE
+/// -----------------------------------------------------------------
+/// feeds the samples of a data file ("t x y z" text or compressed by
+/// rgcodec) until convergence. allocates, hence not for the real-time
+/// path. returns as recgyro_push or RECGYRO_ERR_FILE
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// fname - IN: name of the data file
+/// -----------------------------------------------------------------
+
+int recgyro_push_file(recgyro_calibrator *cal, const char *fname);
+
+///******************************************************************
+/// RECGYRO_OFFSETS
+/// -----------------------------------------------------------------
+/// returns the current offset estimates and acceptance probabilities
+/// (prob may be NULL) together with the status as recgyro_push
+/// -----------------------------------------------------------------
+/// cal   - IN : calibrator
+/// offset- OUT: offsets of the three components
+/// prob  - OUT: acceptance probabilities of the three components
+/// -----------------------------------------------------------------
+
+int recgyro_offsets(const recgyro_calibrator *cal, double offset[], double prob[]);
+
+///******************************************************************
+/// RECGYRO_SAMPLES
+/// -----------------------------------------------------------------
+/// returns the number of samples in the recursion (or RECGYRO_ERR_ARG)
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// -----------------------------------------------------------------
+
+int64_t recgyro_samples(const recgyro_calibrator *cal);
+
+///******************************************************************
+/// RECGYRO_RESET
+/// -----------------------------------------------------------------
+/// restarts the calibration, configuration and callbacks are kept.
+/// returns 0 or RECGYRO_ERR_ARG
+/// -----------------------------------------------------------------
+/// cal   - IN: calibrator
+/// -----------------------------------------------------------------
+
+int recgyro_reset(recgyro_calibrator *cal);
+
+///******************************************************************
+/// RECGYRO_ERROR_STRING
+/// -----------------------------------------------------------------
+/// returns a static description of the status or error code
+/// -----------------------------------------------------------------
+/// code  - IN: return code of a recgyro function
+/// -----------------------------------------------------------------
+
+const char *recgyro_error_string(int code);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //PUBLICATION_RECURSIVE_MEAN_RECGYRO_H
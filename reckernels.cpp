@@ -0,0 +1,256 @@
+//
+// Created by stefan on 14.02.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "reckernels.h"
+#include <math.h>
+
+//erf(k/32) for k=0..128 in Q.RECQ_PROB_BITS
+static const int32_t erf_table[129]={
+    0,2310,4616,6913,9196,11461,13705,15922,
+    18109,20263,22378,24453,26484,28468,30402,32284,
+    34111,35883,37596,39251,40845,42378,43849,45259,
+    46606,47892,49117,50281,51385,52431,53419,54350,
+    55227,56051,56824,57546,58221,58851,59436,59980,
+    60483,60949,61379,61775,62139,62473,62780,63059,
+    63315,63547,63758,63950,64123,64280,64421,64548,
+    64663,64765,64856,64938,65011,65076,65133,65184,
+    65229,65269,65304,65335,65362,65386,65406,65424,
+    65440,65454,65466,65476,65485,65492,65499,65505,
+    65509,65513,65517,65520,65523,65525,65527,65528,
+    65529,65531,65531,65532,65533,65533,65534,65534,
+    65535,65535,65535,65535,65535,65535,65536,65536,
+    65536,65536,65536,65536,65536,65536,65536,65536,
+    65536,65536,65536,65536,65536,65536,65536,65536,
+    65536,65536,65536,65536,65536,65536,65536,65536,
+    65536
+};
+
+//integer division rounded to the nearest integer
+static inline int64_t rdiv(int64_t a, int64_t b)
+{
+    return (a>=0) ? (a+b/2)/b : (a-b/2)/b;
+}
+
+void recstatf::seq_update(float x, int n)
+///******************************************************************
+/// SEQ_UPDATE
+/// -----------------------------------------------------------------
+/// single precision version of recstat::seq_update: computes in
+/// sequence mean, variance, mean of mean and variance of mean
+/// -----------------------------------------------------------------
+/// x     - IN   : newly collected datapoint
+/// n     - IN   : the index of the input value (being the n-th data
+///                point)
+/// -----------------------------------------------------------------
+{
+    float nd,nd1,nd2,d;
+
+    if(n<=1)
+    {
+        ref=x;
+        for(int j=0;j<4;j++) stat[j]=0.0f;
+        return;
+    }
+
+    nd=(float) (n);
+    nd1=(float) (n-1);
+    nd2=(float) (n-2);
+    d=x-ref;
+
+    stat[0]=(nd1*stat[0]+d)/nd;                                                 //mean
+    stat[1]=(nd2/nd1)*stat[1]+(nd/(nd1*nd1))*(d-stat[0])*(d-stat[0]);           //variance
+    stat[2]=(nd1*stat[2]+stat[0])/nd;                                           //mean of mean
+    stat[3]=(nd2/nd1)*stat[3]+(nd/(nd1*nd1))*(stat[0]-stat[2])*(stat[0]-stat[2]); //variance of mean
+}
+
+float recstatf::seq_accept_probability(float f)
+///******************************************************************
+/// SEQ_ACCEPT_PROBABILITY
+/// -----------------------------------------------------------------
+/// single precision version of recstat::seq_accept_probability using
+/// the approximation erf_approx instead of the library erf
+/// -----------------------------------------------------------------
+/// f     - IN   : required fractional accuracy
+/// -----------------------------------------------------------------
+{
+    if(stat[3]<=0.0f) return 1.0f;
+    return erf_approx((f*(ref+stat[2]))/sqrtf(2.0f*stat[3]));
+}
+
+double recstatf::offset()
+///******************************************************************
+/// OFFSET
+/// -----------------------------------------------------------------
+/// returns the current mean of mean (absolute value, i.e. including
+/// the reference value) which is the estimate of the offset
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+{
+    return (double) ref+(double) stat[2];
+}
+
+float recstatf::erf_approx(float x)
+///******************************************************************
+/// ERF_APPROX
+/// -----------------------------------------------------------------
+/// rational approximation 7.1.26 of Abramowitz and Stegun for the
+/// error function. The absolute error is bounded by 1.5e-7 (plus the
+/// rounding error of single precision arithmetic)
+/// -----------------------------------------------------------------
+/// x     - IN   : argument of the error function
+/// -----------------------------------------------------------------
+{
+    float t,y,ax;
+
+    ax=fabsf(x);
+    t=1.0f/(1.0f+0.3275911f*ax);
+    y=t*(0.254829592f+t*(-0.284496736f+t*(1.421413741f+t*(-1.453152027f+t*1.061405429f))));
+    y=1.0f-y*expf(-ax*ax);
+
+    return (x>=0.0f) ? y : -y;
+}
+
+void recstatq::seq_update(int32_t x, int n)
+///******************************************************************
+/// SEQ_UPDATE
+/// -----------------------------------------------------------------
+/// fixed-point version of recstat::seq_update. Only integer additions,
+/// multiplications and divisions are used, products and sums are kept
+/// in 64 bit. The variance of the samples must stay below
+/// 2^(31-RECQ_DATA_BITS) to avoid an overflow of the variance.
+/// -----------------------------------------------------------------
+/// x     - IN   : newly collected datapoint in Q.RECQ_DATA_BITS
+/// n     - IN   : the index of the input value (being the n-th data
+///                point)
+/// -----------------------------------------------------------------
+{
+    int64_t d,mold;
+
+    if(n<=1)
+    {
+        ref=x;
+        for(int j=0;j<4;j++) {stat[j]=0; acc[j]=0;}
+        return;
+    }
+
+    //mean as exact sum of the deviations and variance from the sum of
+    //the squared deviations (welford) - a recursion on the rounded mean
+    //itself would stall as soon as (x-mm)/n drops below one unit
+    d=(int64_t) x-ref;
+    mold=stat[0];
+    acc[0]+=d;
+    stat[0]=(int32_t) rdiv(acc[0],n);
+    acc[1]+=(d-mold)*(d-stat[0]);
+    stat[1]=(int32_t) rdiv(acc[1],(int64_t) (n-1)<<RECQ_DATA_BITS);
+    //mean of mean and variance of mean
+    d=stat[0];
+    mold=stat[2];
+    acc[2]+=d;
+    stat[2]=(int32_t) rdiv(acc[2],n);
+    acc[3]+=(d-mold)*(d-stat[2]);
+    stat[3]=(int32_t) rdiv(acc[3],(int64_t) (n-1)<<RECQ_DATA_BITS);
+}
+
+int32_t recstatq::seq_accept_probability(int32_t f)
+///******************************************************************
+/// SEQ_ACCEPT_PROBABILITY
+/// -----------------------------------------------------------------
+/// fixed-point version of recstat::seq_accept_probability. The square
+/// root is taken by integer bisection and the error function by erf_q
+/// returns the acceptance probability in Q.RECQ_PROB_BITS
+/// -----------------------------------------------------------------
+/// f     - IN   : required fractional accuracy in Q.RECQ_FRAC_BITS
+/// -----------------------------------------------------------------
+{
+    int64_t num,z;
+    uint32_t den;
+
+    if(stat[3]<=0) return 1<<RECQ_PROB_BITS;
+
+    //numerator in Q.(RECQ_FRAC_BITS+RECQ_DATA_BITS)
+    num=(int64_t) f*((int64_t) ref+stat[2]);
+    //denominator sqrt(2*var) in Q.(RECQ_FRAC_BITS+RECQ_DATA_BITS-RECQ_PROB_BITS)
+    den=isqrt(((uint64_t) 2*(uint64_t) stat[3])<<(2*(RECQ_FRAC_BITS-RECQ_PROB_BITS)+RECQ_DATA_BITS));
+    if(den==0) return 1<<RECQ_PROB_BITS;
+
+    z=num/(int64_t) den;
+    if(z>(4<<RECQ_PROB_BITS)) z=4<<RECQ_PROB_BITS;
+    if(z<-(4<<RECQ_PROB_BITS)) z=-(4<<RECQ_PROB_BITS);
+
+    return erf_q((int32_t) z);
+}
+
+double recstatq::offset()
+///******************************************************************
+/// OFFSET
+/// -----------------------------------------------------------------
+/// returns the current mean of mean (absolute value, i.e. including
+/// the reference value) converted to double for reporting
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+{
+    return ((double) ref+(double) stat[2])/(double) (1<<RECQ_DATA_BITS);
+}
+
+int32_t recstatq::erf_q(int32_t z)
+///******************************************************************
+/// ERF_Q
+/// -----------------------------------------------------------------
+/// fixed-point error function by linear interpolation in a table of
+/// erf on [0:4] with step 1/32. The absolute interpolation error is
+/// bounded by max|erf''|/8/32^2 < 1.2e-4, arguments beyond 4 return 1
+/// -----------------------------------------------------------------
+/// z     - IN   : argument of the error function in Q.RECQ_PROB_BITS
+/// -----------------------------------------------------------------
+{
+    int32_t az,i,fr,y;
+    const int shift=RECQ_PROB_BITS-5;   //table step is 2^-5
+
+    az=(z>=0) ? z : -z;
+    if(az>=(4<<RECQ_PROB_BITS)) return (z>=0) ? erf_table[128] : -erf_table[128];
+
+    i=az>>shift;
+    fr=az&((1<<shift)-1);
+    y=erf_table[i]+(((erf_table[i+1]-erf_table[i])*fr)>>shift);
+
+    return (z>=0) ? y : -y;
+}
+
+uint32_t recstatq::isqrt(uint64_t x)
+///******************************************************************
+/// ISQRT
+/// -----------------------------------------------------------------
+/// integer square root floor(sqrt(x)) computed bitwise
+/// -----------------------------------------------------------------
+/// x     - IN   : non-negative input number
+/// -----------------------------------------------------------------
+{
+    uint64_t res=0,bit=(uint64_t) 1<<62;
+
+    while(bit>x) bit>>=2;
+    while(bit!=0)
+    {
+        if(x>=res+bit)
+        {
+            x-=res+bit;
+            res=(res>>1)+bit;
+        }
+        else res>>=1;
+        bit>>=2;
+    }
+    return (uint32_t) res;
+}
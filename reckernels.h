@@ -0,0 +1,167 @@
+//
+// Created by stefan on 14.02.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_RECKERNELS_H
+#define PUBLICATION_RECURSIVE_MEAN_RECKERNELS_H
+
+#include <stdint.h>
+
+//number of fractional bits of the fixed-point data (samples, mean, variance)
+#define RECQ_DATA_BITS 8
+//number of fractional bits of the fractional accuracy f
+#define RECQ_FRAC_BITS 24
+//number of fractional bits of probabilities and of the erf-argument
+#define RECQ_PROB_BITS 16
+
+//*******************************************************************
+// single precision and fixed-point versions of seq_update and
+// seq_accept_probability of the class recstat for targets on which
+// double precision arithmetic is slow or emulated. In contrast to
+// recstat both kernels keep mean and mean of mean relative to a
+// reference value (the first sample) such that the limited mantissa
+// resp. integer range is spent on the fluctuations only.
+//*******************************************************************
+
+class recstatf
+        {
+        private:
+
+        public:
+
+    float ref=0.0f;   //reference value (first sample) of the time series
+    float stat[4];    //mean-ref, variance, mean of mean-ref, variance of mean
+
+    void seq_update(float x, int n);
+
+///******************************************************************
+/// SEQ_UPDATE
+/// -----------------------------------------------------------------
+/// single precision version of recstat::seq_update: computes in
+/// sequence mean, variance, mean of mean and variance of mean
+/// -----------------------------------------------------------------
+/// x     - IN   : newly collected datapoint
+/// n     - IN   : the index of the input value (being the n-th data
+///                point)
+/// -----------------------------------------------------------------
+
+    float seq_accept_probability(float f);
+
+///******************************************************************
+/// SEQ_ACCEPT_PROBABILITY
+/// -----------------------------------------------------------------
+/// single precision version of recstat::seq_accept_probability using
+/// the approximation erf_approx instead of the library erf
+/// -----------------------------------------------------------------
+/// f     - IN   : required fractional accuracy
+/// -----------------------------------------------------------------
+
+    double offset();
+
+///******************************************************************
+/// OFFSET
+/// -----------------------------------------------------------------
+/// returns the current mean of mean (absolute value, i.e. including
+/// the reference value) which is the estimate of the offset
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+
+    static float erf_approx(float x);
+
+///******************************************************************
+/// ERF_APPROX
+/// -----------------------------------------------------------------
+/// rational approximation 7.1.26 of Abramowitz and Stegun for the
+/// error function. The absolute error is bounded by 1.5e-7 (plus the
+/// rounding error of single precision arithmetic)
+/// -----------------------------------------------------------------
+/// x     - IN   : argument of the error function
+/// -----------------------------------------------------------------
+
+        };
+
+class recstatq
+        {
+        private:
+
+        public:
+
+    int32_t ref=0;    //reference value (first sample) in Q.RECQ_DATA_BITS
+    int32_t stat[4];  //as in recstatf, all values in Q.RECQ_DATA_BITS
+    int64_t acc[4];   //sums of the deviations and of the squared deviations
+
+    void seq_update(int32_t x, int n);
+
+///******************************************************************
+/// SEQ_UPDATE
+/// -----------------------------------------------------------------
+/// fixed-point version of recstat::seq_update. Only integer additions,
+/// multiplications and divisions are used, products and sums are kept
+/// in 64 bit. The variance of the samples must stay below
+/// 2^(31-RECQ_DATA_BITS) to avoid an overflow of the variance.
+/// -----------------------------------------------------------------
+/// x     - IN   : newly collected datapoint in Q.RECQ_DATA_BITS
+/// n     - IN   : the index of the input value (being the n-th data
+///                point)
+/// -----------------------------------------------------------------
+
+    int32_t seq_accept_probability(int32_t f);
+
+///******************************************************************
+/// SEQ_ACCEPT_PROBABILITY
+/// -----------------------------------------------------------------
+/// fixed-point version of recstat::seq_accept_probability. The square
+/// root is taken by integer bisection and the error function by erf_q
+/// returns the acceptance probability in Q.RECQ_PROB_BITS
+/// -----------------------------------------------------------------
+/// f     - IN   : required fractional accuracy in Q.RECQ_FRAC_BITS
+/// -----------------------------------------------------------------
+
+    double offset();
+
+///******************************************************************
+/// OFFSET
+/// -----------------------------------------------------------------
+/// returns the current mean of mean (absolute value, i.e. including
+/// the reference value) converted to double for reporting
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+
+    static int32_t erf_q(int32_t z);
+
+///******************************************************************
+/// ERF_Q
+/// -----------------------------------------------------------------
+/// fixed-point error function by linear interpolation in a table of
+/// erf on [0:4] with step 1/32. The absolute interpolation error is
+/// bounded by max|erf''|/8/32^2 < 1.2e-4, arguments beyond 4 return 1
+/// -----------------------------------------------------------------
+/// z     - IN   : argument of the error function in Q.RECQ_PROB_BITS
+/// -----------------------------------------------------------------
+
+    static uint32_t isqrt(uint64_t x);
+
+///******************************************************************
+/// ISQRT
+/// -----------------------------------------------------------------
+/// integer square root floor(sqrt(x)) computed bitwise
+/// -----------------------------------------------------------------
+/// x     - IN   : non-negative input number
+/// -----------------------------------------------------------------
+
+        };
+
+#endif //PUBLICATION_RECURSIVE_MEAN_RECKERNELS_H
@@ -18,6 +18,17 @@
 #include "recstats.h"
 #include <math.h>
 
+//adds d to the compensated sum (kahan): s is the sum rounded to double and
+//c the negative of the low order part which was lost, it is carried into
+//the next increment
+static inline void comp_add(double &s, double &c, double d)
+{
+    double y=d-c,t=s+y;
+
+    c=(t-s)-y;
+    s=t;
+}
+
 
 void recstat::mean(double &mm, double x, int n)
 ///******************************************************************
@@ -105,4 +116,184 @@ double recstat::seq_accept_probability(double stat[], double f)
 /// -----------------------------------------------------------------
 {
     return (erf((f*stat[2])/(sqrt(2*stat[3]))));
-}
\ No newline at end of file
+}
+
+//median of the n values in v (sorted in place)
+static double median(double v[], int n)
+{
+    for(int k=1;k<n;k++)
+    {
+        double y=v[k];
+        int l=k;
+        for(;l>0 && v[l-1]>y;l--) v[l]=v[l-1];
+        v[l]=y;
+    }
+    return (n%2==1) ? v[n/2] : 0.5*(v[n/2-1]+v[n/2]);
+}
+
+//end of the warm-up of seq_update_robust: the samples held back in
+//stat[8..] are gated against their median with c times the median absolute
+//deviation (scaled to the standard deviation of normal data), so a spike
+//in the warm-up can not enter the mean and the variance which define the
+//gate afterwards; without spread (MAD 0) all samples are accepted
+static void robust_seed(recstat &rs, double stat[], double c)
+{
+    double v[RECSTAT_ROBUST_WARMUP],med,mad;
+    const double *w=stat+RECSTAT_ROBUST_HOLD;
+
+    for(int k=0;k<RECSTAT_ROBUST_WARMUP;k++) v[k]=w[k];
+    med=median(v,RECSTAT_ROBUST_WARMUP);
+    for(int k=0;k<RECSTAT_ROBUST_WARMUP;k++) v[k]=fabs(w[k]-med);
+    mad=1.4826*median(v,RECSTAT_ROBUST_WARMUP);
+    for(int k=0;k<RECSTAT_ROBUST_WARMUP;k++)
+    {
+        if(mad>0.0 && fabs(w[k]-med)>c*mad)
+        {
+            stat[RECSTAT_ROBUST_REJECTED]+=1.0;
+            continue;
+        }
+        stat[RECSTAT_ROBUST_ACCEPTED]+=1.0;
+        rs.seq_update(stat,w[k],(int) stat[RECSTAT_ROBUST_ACCEPTED]);
+    }
+}
+
+int recstat::seq_update_robust(double stat[], double x, double c)
+///******************************************************************
+/// SEQ_UPDATE_ROBUST
+/// -----------------------------------------------------------------
+/// outlier resistant version of seq_update (hampel gate): a sample
+/// whose deviation from the current mean exceeds c standard deviations
+/// is rejected and does not enter the recursion, such that a single
+/// spike can not inflate the variance. The gate is seeded robustly:
+/// the first RECSTAT_ROBUST_WARMUP samples are held back in stat[8..]
+/// and then gated against their median with c times the normalized
+/// median absolute deviation, the accepted ones enter the recursion in
+/// their order. stat[0..3] have the meaning of seq_update (zero during
+/// the warm-up), stat[4] is the number of accepted samples, stat[5] the
+/// number of rejected samples, stat[RECSTAT_ROBUST_RUN] the number of consecutive
+/// rejections and stat[7] the number of samples held back. stat has to
+/// be zero-initialized. returns 1 if the sample was accepted or held
+/// back and 0 if it was rejected
+/// -----------------------------------------------------------------
+/// stat  - INOUT: storage array of size RECSTAT_ROBUST_SIZE
+/// x     - IN   : newly collected datapoint
+/// c     - IN   : gate width in standard deviations (e.g. 5)
+/// -----------------------------------------------------------------
+{
+    double d;
+    bool outside;
+
+    if(!robust_seeded(stat))
+    {
+        stat[RECSTAT_ROBUST_HOLD+(int) stat[RECSTAT_ROBUST_HELD]]=x;
+        stat[RECSTAT_ROBUST_HELD]+=1.0;
+        if(robust_seeded(stat)) robust_seed(*this,stat,c);
+        return 1;
+    }
+    //compare squares to avoid the square root on the hot path
+    d=x-stat[0];
+    outside=(d*d>c*c*stat[1]);
+    if(outside && stat[RECSTAT_ROBUST_RUN]<RECSTAT_ROBUST_MAX_RUN)
+    {
+        stat[RECSTAT_ROBUST_REJECTED]+=1.0;
+        stat[RECSTAT_ROBUST_RUN]+=1.0;
+        return 0;
+    }
+    //a long run of samples outside the gate is a change of the level:
+    //they are accepted until the gate has widened to include them
+    if(!outside) stat[RECSTAT_ROBUST_RUN]=0.0;
+    stat[RECSTAT_ROBUST_ACCEPTED]+=1.0;
+    seq_update(stat,x,(int) stat[RECSTAT_ROBUST_ACCEPTED]);
+    return 1;
+}
+
+bool recstat::robust_seeded(const double stat[])
+///******************************************************************
+/// ROBUST_SEEDED
+/// -----------------------------------------------------------------
+/// returns true once the warm-up of seq_update_robust is complete,
+/// before stat[0..3] are zero and seq_accept_probability is undefined
+/// -----------------------------------------------------------------
+/// stat  - IN: storage array of seq_update_robust
+/// -----------------------------------------------------------------
+{
+    return stat[RECSTAT_ROBUST_HELD]>=RECSTAT_ROBUST_WARMUP;
+}
+
+void recstat::seq_update_long(double stat[], double x, int64_t n)
+///******************************************************************
+/// SEQ_UPDATE_LONG
+/// -----------------------------------------------------------------
+/// long-horizon version of seq_update with a 64-bit sample index:
+/// the four quantities are updated by increments (e.g. mean+=(x-mean)/n)
+/// instead of the rescaling with (n-1)/n, and the increments of the mean
+/// and of the mean of mean (the offset) are added with compensation
+/// (kahan), such that their rounding errors do not accumulate over
+/// billions of samples. stat[0..3] have the meaning of seq_update
+/// (seq_accept_probability applies unchanged), stat[4..5] hold the
+/// compensation terms. stat has to be zero-initialized
+/// -----------------------------------------------------------------
+/// stat  - INOUT: storage array of size RECSTAT_LONG_SIZE
+/// x     - IN   : newly collected datapoint
+/// n     - IN   : the index of the input value (being the n-th data
+///                point)
+/// -----------------------------------------------------------------
+{
+    double nd=(double) n,inv,w,e;
+
+    inv=1.0/nd;
+    //mean and mean of mean (the true values are stat[0]-stat[4] and stat[2]-stat[5])
+    comp_add(stat[0],stat[4],((x-stat[0])+stat[4])*inv);
+    comp_add(stat[2],stat[5],((stat[0]-stat[2])-(stat[4]-stat[5]))*inv);
+    if(n<=1) return;
+
+    //variances: var_n=var_{n-1}+(n/(n-1)*(x-mean_n)^2-var_{n-1})/(n-1),
+    //which is the recursion of var with the rescaling split off. they only
+    //enter the acceptance probability and are not compensated
+    w=1.0/(nd-1.0);
+    e=(x-stat[0])+stat[4];
+    stat[1]+=(nd*w*e*e-stat[1])*w;
+    e=(stat[0]-stat[2])-(stat[4]-stat[5]);
+    stat[3]+=(nd*w*e*e-stat[3])*w;
+}
+
+void recstat::seq_update_weighted(double stat[], double x, double w)
+///******************************************************************
+/// SEQ_UPDATE_WEIGHTED
+/// -----------------------------------------------------------------
+/// weighted version of seq_update, e.g. with the time interval a
+/// sample stands for as weight w: mean and mean of mean are weighted
+/// means, the variances use the reliability weights correction
+/// W-sum(w^2)/W instead of n-1. for equal weights the four quantities
+/// are those of seq_update (seq_accept_probability applies unchanged),
+/// a weight of 0 leaves stat unchanged. stat[4] is the sum of the
+/// weights, stat[5] the sum of their squares, stat[6..7] the centered
+/// sums of squares of the samples and of the means. stat has to be
+/// zero-initialized
+/// -----------------------------------------------------------------
+/// stat  - INOUT: storage array of size RECSTAT_WEIGHTED_SIZE
+/// x     - IN   : newly collected datapoint
+/// w     - IN   : weight of the datapoint (>=0)
+/// -----------------------------------------------------------------
+{
+    double r,d,dm,den;
+
+    if(!(w>0.0)) return;
+    stat[4]+=w;
+    stat[5]+=w*w;
+    r=w/stat[4];
+    //weighted welford updates of the samples and of the running means
+    d=x-stat[0];
+    stat[0]+=r*d;
+    stat[6]+=w*d*(x-stat[0]);
+    dm=stat[0]-stat[2];
+    stat[2]+=r*dm;
+    stat[7]+=w*dm*(stat[0]-stat[2]);
+
+    den=stat[4]-stat[5]/stat[4];
+    if(den>0.0)
+    {
+        stat[1]=stat[6]/den;
+        stat[3]=stat[7]/den;
+    }
+}
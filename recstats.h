@@ -18,6 +18,26 @@
 #ifndef PUBLICATION_RECURSIVE_MEAN_RECSTATS_H
 #define PUBLICATION_RECURSIVE_MEAN_RECSTATS_H
 
+//number of initial samples from which the gate is seeded (median and MAD)
+#define RECSTAT_ROBUST_WARMUP 16
+//slots of the stat-array of seq_update_robust behind those of seq_update
+#define RECSTAT_ROBUST_ACCEPTED 4     //number of accepted samples
+#define RECSTAT_ROBUST_REJECTED 5     //number of rejected samples
+#define RECSTAT_ROBUST_RUN 6          //number of consecutive rejections
+#define RECSTAT_ROBUST_HELD 7         //number of samples held back in the warm-up
+#define RECSTAT_ROBUST_HOLD 8         //first of the samples held back
+//size of the stat-array of seq_update_robust (8 values and the warm-up samples)
+#define RECSTAT_ROBUST_SIZE (RECSTAT_ROBUST_HOLD+RECSTAT_ROBUST_WARMUP)
+//consecutive rejections after which a sample is accepted anyway such that
+//a genuine change of the level is followed
+#define RECSTAT_ROBUST_MAX_RUN 32
+//size of the stat-array of seq_update_long
+#define RECSTAT_LONG_SIZE 6
+//size of the stat-array of seq_update_weighted
+#define RECSTAT_WEIGHTED_SIZE 8
+
+#include <stdint.h>
+
 class recstat
         {
         private:
@@ -81,6 +101,81 @@ class recstat
 /// -----------------------------------------------------------------
 /// stat  - INOUT: storage array for all relevant statistical values
 /// f     - IN   : required fractional accuracy
+/// -----------------------------------------------------------------
+
+     int seq_update_robust(double stat[], double x, double c);
+
+///******************************************************************
+/// SEQ_UPDATE_ROBUST
+/// -----------------------------------------------------------------
+/// outlier resistant version of seq_update (hampel gate): a sample
+/// whose deviation from the current mean exceeds c standard deviations
+/// is rejected and does not enter the recursion, such that a single
+/// spike can not inflate the variance. The gate is seeded robustly:
+/// the first RECSTAT_ROBUST_WARMUP samples are held back in stat[8..]
+/// and then gated against their median with c times the normalized
+/// median absolute deviation, the accepted ones enter the recursion in
+/// their order. stat[0..3] have the meaning of seq_update (zero during
+/// the warm-up), stat[4] is the number of accepted samples, stat[5] the
+/// number of rejected samples, stat[6] the number of consecutive
+/// rejections and stat[7] the number of samples held back. stat has to
+/// be zero-initialized. returns 1 if the sample was accepted or held
+/// back and 0 if it was rejected
+/// -----------------------------------------------------------------
+/// stat  - INOUT: storage array of size RECSTAT_ROBUST_SIZE
+/// x     - IN   : newly collected datapoint
+/// c     - IN   : gate width in standard deviations (e.g. 5)
+/// -----------------------------------------------------------------
+
+     static bool robust_seeded(const double stat[]);
+
+///******************************************************************
+/// ROBUST_SEEDED
+/// -----------------------------------------------------------------
+/// returns true once the warm-up of seq_update_robust is complete,
+/// before stat[0..3] are zero and seq_accept_probability is undefined
+/// -----------------------------------------------------------------
+/// stat  - IN: storage array of seq_update_robust
+/// -----------------------------------------------------------------
+
+     void seq_update_long(double stat[], double x, int64_t n);
+
+///******************************************************************
+/// SEQ_UPDATE_LONG
+/// -----------------------------------------------------------------
+/// long-horizon version of seq_update with a 64-bit sample index:
+/// the four quantities are updated by increments (e.g. mean+=(x-mean)/n)
+/// instead of the rescaling with (n-1)/n, and the increments of the mean
+/// and of the mean of mean (the offset) are added with compensation
+/// (kahan), such that their rounding errors do not accumulate over
+/// billions of samples. stat[0..3] have the meaning of seq_update
+/// (seq_accept_probability applies unchanged), stat[4..5] hold the
+/// compensation terms. stat has to be zero-initialized
+/// -----------------------------------------------------------------
+/// stat  - INOUT: storage array of size RECSTAT_LONG_SIZE
+/// x     - IN   : newly collected datapoint
+/// n     - IN   : the index of the input value (being the n-th data
+///                point)
+/// -----------------------------------------------------------------
+
+     void seq_update_weighted(double stat[], double x, double w);
+
+///******************************************************************
+/// SEQ_UPDATE_WEIGHTED
+/// -----------------------------------------------------------------
+/// weighted version of seq_update, e.g. with the time interval a
+/// sample stands for as weight w: mean and mean of mean are weighted
+/// means, the variances use the reliability weights correction
+/// W-sum(w^2)/W instead of n-1. for equal weights the four quantities
+/// are those of seq_update (seq_accept_probability applies unchanged),
+/// a weight of 0 leaves stat unchanged. stat[4] is the sum of the
+/// weights, stat[5] the sum of their squares, stat[6..7] the centered
+/// sums of squares of the samples and of the means. stat has to be
+/// zero-initialized
+/// -----------------------------------------------------------------
+/// stat  - INOUT: storage array of size RECSTAT_WEIGHTED_SIZE
+/// x     - IN   : newly collected datapoint
+/// w     - IN   : weight of the datapoint (>=0)
 /// -----------------------------------------------------------------
 
         };
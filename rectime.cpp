@@ -0,0 +1,104 @@
+//
+// Created by stefan on 25.05.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "rectime.h"
+
+rectime::rectime()
+{
+    reset();
+}
+
+void rectime::reset()
+///******************************************************************
+/// RESET
+/// -----------------------------------------------------------------
+/// discards all samples and the learned nominal interval
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+{
+    for(int j=0;j<3;j++) for(int k=0;k<RECSTAT_WEIGHTED_SIZE;k++) stat[j][k]=0.0;
+    tlast=dt_nom=tgap=0.0;
+    nlearn=0;
+    n=ndup=ngap=0;
+}
+
+int rectime::update(const expdata::dynamic &s)
+///******************************************************************
+/// UPDATE
+/// -----------------------------------------------------------------
+/// classifies the time stamped sample s and adds it with its weight
+/// to the recursion of the three components unless it is a
+/// duplicate. returns RECTIME_REGULAR, RECTIME_GAP or
+/// RECTIME_DUPLICATE
+/// -----------------------------------------------------------------
+/// s     - IN: sample (t,x,y,z)
+/// -----------------------------------------------------------------
+{
+    double dt,w=1.0;
+    int type=RECTIME_REGULAR;
+
+    if(n>0)
+    {
+        dt=s.t-tlast;
+        if(nominal>0.0) dt_nom=nominal;
+        else if(nlearn<RECTIME_LEARN && dt>0.0)
+        {
+            //insertion into the sorted intervals, the median is the nominal interval
+            int k=nlearn++;
+            for(;k>0 && learn[k-1]>dt;k--) learn[k]=learn[k-1];
+            learn[k]=dt;
+            dt_nom=learn[nlearn/2];
+        }
+        if(dt_nom<=0.0 || dt<=dup_factor*dt_nom)
+        {
+            ndup++;
+            return RECTIME_DUPLICATE;
+        }
+        if(dt>gap_factor*dt_nom)
+        {
+            //the sample after a gap stands for one nominal interval
+            type=RECTIME_GAP;
+            ngap++;
+            tgap+=dt-dt_nom;
+        }
+        else w=dt/dt_nom;
+    }
+    tlast=s.t;
+    n++;
+    rs.seq_update_weighted(stat[0],s.x,w);
+    rs.seq_update_weighted(stat[1],s.y,w);
+    rs.seq_update_weighted(stat[2],s.z,w);
+    return type;
+}
+
+double rectime::accept_probability(int j, double f) const
+///******************************************************************
+/// ACCEPT_PROBABILITY
+/// -----------------------------------------------------------------
+/// acceptance probability of component j for the fractional accuracy
+/// f (recstat::seq_accept_probability of the weighted recursion)
+/// -----------------------------------------------------------------
+/// j     - IN: component (0..2)
+/// f     - IN: required fractional accuracy
+/// -----------------------------------------------------------------
+{
+    double s[4]={stat[j][0],stat[j][1],stat[j][2],stat[j][3]};
+    recstat r;
+
+    //no variance before the second sample
+    if(n<2) return 0.0;
+    return r.seq_accept_probability(s,f);
+}
@@ -0,0 +1,114 @@
+//
+// Created by stefan on 25.05.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_RECTIME_H
+#define PUBLICATION_RECURSIVE_MEAN_RECTIME_H
+
+#include "expdata.h"
+#include "recstats.h"
+#include <stdint.h>
+
+//classification of a sample by the interval to its predecessor
+#define RECTIME_REGULAR 0             //interval up to gap_factor nominal intervals
+#define RECTIME_GAP 1                 //longer interval, samples were dropped
+#define RECTIME_DUPLICATE 2           //interval up to dup_factor nominal intervals (or
+                                      //negative): repeated or out of order, ignored
+#define RECTIME_LEARN 15              //intervals whose median is the learned nominal interval
+
+//*******************************************************************
+// streaming calibration of the three components on irregularly time
+// stamped samples (dropped packets, bursts, repeated samples): every
+// sample is classified by the interval to the previous one against the
+// nominal interval (given, or the median of the first RECTIME_LEARN
+// intervals), duplicates are ignored and the others enter the
+// recursion (recstat::seq_update_weighted) with the time they stand
+// for as weight, the interval in nominal intervals, for the sample
+// after a gap one nominal interval. Samples of a burst then count
+// with the time they cover instead of one full sample each, and no
+// resampling pass over the recording is needed. Gaps are counted with
+// the missing time, such that a convergence decision made across a
+// gap can be flagged.
+//*******************************************************************
+
+class rectime {
+
+private:
+
+    recstat rs;
+    double stat[3][RECSTAT_WEIGHTED_SIZE];
+    double tlast=0.0;         //time stamp of the last sample which was not a duplicate
+    double dt_nom=0.0;        //nominal interval in use (0: not known yet)
+    double learn[RECTIME_LEARN];  //sorted intervals for the learned nominal interval
+    int nlearn=0;
+    int64_t n=0;              //samples in the recursion
+    int64_t ndup=0;           //ignored duplicates
+    int64_t ngap=0;           //gaps
+    double tgap=0.0;          //time missing in the gaps (beyond one nominal interval)
+
+public:
+
+    double nominal=0.0;       //nominal interval (0: learned from the data)
+    double gap_factor=2.5;    //intervals beyond gap_factor nominal intervals are gaps
+    double dup_factor=0.1;    //intervals up to dup_factor nominal intervals are duplicates
+
+    rectime();
+
+    ///******************************************************************
+    /// RESET
+    /// -----------------------------------------------------------------
+    /// discards all samples and the learned nominal interval
+    /// -----------------------------------------------------------------
+    /// no input arguments
+    /// -----------------------------------------------------------------
+
+    void reset();
+
+    ///******************************************************************
+    /// UPDATE
+    /// -----------------------------------------------------------------
+    /// classifies the time stamped sample s and adds it with its weight
+    /// to the recursion of the three components unless it is a
+    /// duplicate. returns RECTIME_REGULAR, RECTIME_GAP or
+    /// RECTIME_DUPLICATE
+    /// -----------------------------------------------------------------
+    /// s     - IN: sample (t,x,y,z)
+    /// -----------------------------------------------------------------
+
+    int update(const expdata::dynamic &s);
+
+    ///******************************************************************
+    /// ACCEPT_PROBABILITY
+    /// -----------------------------------------------------------------
+    /// acceptance probability of component j for the fractional accuracy
+    /// f (recstat::seq_accept_probability of the weighted recursion)
+    /// -----------------------------------------------------------------
+    /// j     - IN: component (0..2)
+    /// f     - IN: required fractional accuracy
+    /// -----------------------------------------------------------------
+
+    double accept_probability(int j, double f) const;
+
+    double offset(int j) const {return stat[j][2];}
+    double weight() const {return stat[0][4];}
+    double interval() const {return dt_nom;}
+    int64_t samples() const {return n;}
+    int64_t duplicates() const {return ndup;}
+    int64_t gaps() const {return ngap;}
+    double gap_time() const {return tgap;}
+    bool across_gap() const {return ngap>0;}
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_RECTIME_H
@@ -0,0 +1,216 @@
+//
+// Created by stefan on 18.05.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+//*******************************************************************
+// real-time replay of a recording into the calibrator (librecgyro):
+// every sample is released at its original time stamp divided by the
+// speed factor (0: as fast as possible) and stamped with the monotonic
+// clock on release, after the update and in the convergence callback.
+// After every convergence the offsets are fetched and the calibrator
+// is restarted, such that a recording yields many convergence events.
+// Reported are percentiles of
+//   release jitter - release time minus scheduled time
+//   update         - release of a sample until push returned
+//   notification   - release of the converging sample until the
+//                    convergence callback ran
+//   offsets        - release of the converging sample until the
+//                    offsets were fetched (end to end)
+// optionally while background threads load the cores with a duty
+// cycle. Waiting sleeps until shortly before the release time and
+// spins for the rest, which is what an acquisition loop does.
+//*******************************************************************
+
+#include "baserandom.h"
+#include "calibrator.h"
+#include "expdata.h"
+#include "metrics.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+using namespace std;
+
+#define REPLAY_SPIN_NS 200000     //spin instead of sleeping within the last 200 us
+#define REPLAY_LOAD_PERIOD_NS 1000000 //period of the duty cycle of the background load
+
+enum latency {L_JITTER=0,L_UPDATE,L_NOTIFY,L_OFFSETS,L_NUM};
+static const char *lname[L_NUM]={"release jitter","update","notification","offsets"};
+
+typedef struct replay_event
+{
+    uint64_t t_notify;        //clock in the convergence callback
+    int64_t n;                //samples to convergence
+} event;
+
+static void on_done(void *user, int64_t n, const double offset[])
+{
+    event *e=(event *) user;
+
+    (void) offset;
+    e->t_notify=metrics::now();
+    e->n=n;
+}
+
+//busy for duty of every period, sleeps for the rest, until stop is set
+static void background_load(double duty, const atomic<bool> *stop)
+{
+    volatile double acc=1.0;
+    uint64_t busy=(uint64_t) (duty*REPLAY_LOAD_PERIOD_NS);
+
+    while(!stop->load(memory_order_relaxed))
+    {
+        uint64_t t0=metrics::now();
+        while(metrics::now()-t0<busy) acc=acc*1.0000001+1.0e-7;
+        if(busy<REPLAY_LOAD_PERIOD_NS) this_thread::sleep_for(chrono::nanoseconds(REPLAY_LOAD_PERIOD_NS-busy));
+    }
+}
+
+//waits until the monotonic clock reaches t
+static void wait_until(uint64_t t)
+{
+    uint64_t now=metrics::now();
+
+    if(t>now+REPLAY_SPIN_NS) this_thread::sleep_for(chrono::nanoseconds(t-now-REPLAY_SPIN_NS));
+    while(metrics::now()<t);
+}
+
+//value below which the fraction q of the sorted values v lies
+static uint64_t percentile(const vector<uint64_t> &v, double q)
+{
+    size_t i;
+
+    if(v.empty()) return 0;
+    i=(size_t) ceil(q*(double) v.size());
+    return v[(i>0) ? i-1 : 0];
+}
+
+static void synthetic(samplestore &store, int n, double rate)
+{
+    const double bias[3]={32777.15,32459.82,32511.85},sigma=987.34;
+    ranbase randy;
+
+    randy.initialize_stream(2,1);
+    store.resize(n);
+    for(int k=0;k<n;k++)
+    {
+        double x[3];
+        for(int j=0;j<3;j++) x[j]=bias[j]+sigma*randy.ran_gauss();
+        store.set(k,(double) k/rate,x[0],x[1],x[2]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *fname="test_data/xsens_gyro.mat";
+    double speed=1.0,duty=1.0,rate=100.0;
+    int load=0,nmax=0,n,converged=0;
+    samplestore store;
+    calibrator cal;
+    event e;
+    vector<uint64_t> lat[L_NUM];
+    vector<thread> workers;
+    atomic<bool> stop(false);
+    uint64_t start,t_rel,t_upd,t_off,sched;
+    double x[3],off[3];
+
+    for(int k=1;k<argc;k++)
+    {
+        if(strcmp(argv[k],"--speed")==0 && k+1<argc) speed=atof(argv[++k]);
+        else if(strcmp(argv[k],"--load")==0 && k+1<argc) load=atoi(argv[++k]);
+        else if(strcmp(argv[k],"--duty")==0 && k+1<argc) duty=atof(argv[++k]);
+        else if(strcmp(argv[k],"--samples")==0 && k+1<argc) nmax=atoi(argv[++k]);
+        else if(strcmp(argv[k],"--rate")==0 && k+1<argc) rate=atof(argv[++k]);
+        else if(strncmp(argv[k],"--",2)!=0) fname=argv[k];
+        else
+        {
+            printf("usage: %s [<data file>|synthetic] [--speed <factor, 0: unpaced>] [--samples <n>]\n",argv[0]);
+            printf("       [--rate <Hz of synthetic data>] [--load <background threads>] [--duty <busy fraction>]\n");
+            return 1;
+        }
+    }
+    if(speed<0.0 || rate<=0.0 || load<0 || duty<0.0 || duty>1.0)
+    {
+        printf("invalid arguments\n");
+        return 1;
+    }
+
+    if(strcmp(fname,"synthetic")==0)
+    {
+        n=(nmax>0) ? nmax : 50000;
+        synthetic(store,n,rate);
+    }
+    else if((n=expdata::read_file(fname,store))<0)
+    {
+        printf("%s: %s\n",expdata::read_error(n),fname);
+        return 1;
+    }
+    if(nmax>0 && nmax<n) n=nmax;
+    if(n<1)
+    {
+        printf("no samples in: %s\n",fname);
+        return 1;
+    }
+    for(int l=0;l<L_NUM;l++) lat[l].reserve(n);
+
+    cal.set_callbacks(nullptr,on_done,&e);
+    for(int r=0;r<load;r++) workers.emplace_back(background_load,duty,&stop);
+
+    start=metrics::now();
+    for(int i=0;i<n;i++)
+    {
+        sched=start;
+        if(speed>0.0)
+        {
+            sched+=(uint64_t) (1.0e9*(store.time(i)-store.time(0))/speed);
+            wait_until(sched);
+        }
+        for(int j=0;j<3;j++) x[j]=store.get(j,i);
+        t_rel=metrics::now();
+        int res=cal.push(x);
+        t_upd=metrics::now();
+        if(speed>0.0) lat[L_JITTER].push_back(t_rel-sched);
+        lat[L_UPDATE].push_back(t_upd-t_rel);
+        if(res==RECGYRO_CONVERGED)
+        {
+            cal.offsets(off,nullptr);
+            t_off=metrics::now();
+            lat[L_NOTIFY].push_back(e.t_notify-t_rel);
+            lat[L_OFFSETS].push_back(t_off-t_rel);
+            converged++;
+            cal.reset();
+        }
+    }
+    stop=true;
+    for(auto &w : workers) w.join();
+
+    printf("replay of %s: %d samples at speed %g%s, %d background threads at duty %g, %d convergences (%.3f s)\n",
+           fname,n,speed,(speed>0.0) ? "" : " (unpaced)",load,duty,converged,1.0e-9*(metrics::now()-start));
+    printf("%-16s %8s %10s %10s %10s %10s %10s\n","latency [ns]","count","p50","p90","p99","p99.9","max");
+    for(int l=0;l<L_NUM;l++)
+    {
+        sort(lat[l].begin(),lat[l].end());
+        printf("%-16s %8lu %10lu %10lu %10lu %10lu %10lu\n",lname[l],(unsigned long) lat[l].size(),
+               (unsigned long) percentile(lat[l],0.5),(unsigned long) percentile(lat[l],0.9),(unsigned long) percentile(lat[l],0.99),
+               (unsigned long) percentile(lat[l],0.999),(unsigned long) (lat[l].empty() ? 0 : lat[l].back()));
+    }
+
+    return 0;
+}
@@ -0,0 +1,420 @@
+//
+// Created by stefan on 30.03.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "rgcodec.h"
+#include <math.h>
+#include <string.h>
+#include <limits.h>
+
+#define RGCODEC_COLUMN_HEAD 24        //bytes of a column header
+
+//column header as stored in the file
+typedef struct rgcodec_column
+{
+    uint8_t mode;                     //0: packed integers, 1: raw doubles
+    uint8_t scale;                    //decimal scale k of the packed integers
+    uint8_t width;                    //bits per packed value
+    uint8_t order;                    //order of the differences
+    uint32_t reserved;
+    int64_t head[2];                  //the first order values (not packed)
+} column_head;
+
+static_assert(sizeof(column_head)==RGCODEC_COLUMN_HEAD,"unexpected padding of the column header");
+
+static const double pow10_table[RGCODEC_MAX_SCALE+1]={1.0,1.0e1,1.0e2,1.0e3,1.0e4,1.0e5,1.0e6,1.0e7,1.0e8,1.0e9};
+
+static inline uint64_t zigzag(int64_t v) {return ((uint64_t) v<<1)^(uint64_t) (v>>63);}
+static inline int64_t unzigzag(uint64_t v) {return (int64_t) (v>>1)^-(int64_t) (v&1);}
+
+//value of the integer q at the decimal scale k (exactly as used for the check)
+static inline double unscale(int64_t q, int k) {return (k==0) ? (double) q : (double) q/pow10_table[k];}
+
+//true if the values are bitwise the same
+static inline bool same_bits(double a, double b) {return memcmp(&a,&b,sizeof(double))==0;}
+
+//maps v exactly onto an integer at scale k if possible
+static inline bool to_integer(double v, int k, int64_t &q)
+{
+    double s=v*pow10_table[k];
+
+    if(!(fabs(s)<9.0e15)) return false;   //also rejects nan
+    q=llround(s);
+    return same_bits(unscale(q,k),v);
+}
+
+//appends the bytes of v
+template <class T>
+static void put(vector<uint8_t> &out, const T &v)
+{
+    const uint8_t *b=(const uint8_t *) &v;
+    out.insert(out.end(),b,b+sizeof(T));
+}
+
+//encodes the column c[0..n-1] with differences of the given order
+static void encode_column(const double c[], int n, int order, vector<uint8_t> &out)
+{
+    column_head h;
+    vector<int64_t> q(n);
+    int k=0,i;
+    uint64_t zmax=0;
+
+    memset(&h,0,sizeof(h));
+    if(order>n) order=n;
+    //smallest decimal scale which maps the first samples exactly, then check all
+    for(i=0;i<n && k<=RGCODEC_MAX_SCALE;i++)
+    {
+        while(k<=RGCODEC_MAX_SCALE && !to_integer(c[i],k,q[i])) k++;
+    }
+    for(i=0;i<n && k<=RGCODEC_MAX_SCALE;i++)
+    {
+        if(!to_integer(c[i],k,q[i])) k=RGCODEC_MAX_SCALE+1;
+    }
+
+    if(k>RGCODEC_MAX_SCALE)
+    {
+        h.mode=1;
+        put(out,h);
+        out.insert(out.end(),(const uint8_t *) c,(const uint8_t *) (c+n));
+        return;
+    }
+
+    //differences of the requested order (in place from the end)
+    for(int o=0;o<order;o++)
+    {
+        for(i=n-1;i>o;i--) q[i]-=q[i-1];
+    }
+    for(i=order;i<n;i++) zmax|=zigzag(q[i]);
+    h.mode=0;
+    h.scale=(uint8_t) k;
+    h.order=(uint8_t) order;
+    h.width=0;
+    while(h.width<64 && (zmax>>h.width)!=0) h.width++;
+    for(i=0;i<order;i++) h.head[i]=q[i];
+    put(out,h);
+
+    //bit-packing of the zigzag coded differences
+    size_t m=(size_t) (n-order),words=(m*h.width+63)/64;
+    vector<uint64_t> w(words,0);
+    for(size_t j=0;j<m && h.width>0;j++)
+    {
+        uint64_t z=zigzag(q[order+j]);
+        size_t bit=j*h.width,word=bit>>6;
+        int off=(int) (bit&63);
+        w[word]|=z<<off;
+        if(off+h.width>64) w[word+1]|=z>>(64-off);
+    }
+    out.insert(out.end(),(const uint8_t *) w.data(),(const uint8_t *) (w.data()+words));
+}
+
+//bytes of the column of n values at p (header included), 0 if its header
+//is corrupt or it is longer than size
+static size_t column_size(const uint8_t *p, size_t size, size_t n)
+{
+    column_head h;
+    size_t used;
+
+    if(size<RGCODEC_COLUMN_HEAD) return 0;
+    memcpy(&h,p,RGCODEC_COLUMN_HEAD);
+    if(h.mode==1) used=RGCODEC_COLUMN_HEAD+n*sizeof(double);
+    else if(h.mode!=0 || h.scale>RGCODEC_MAX_SCALE || h.width>64 || h.order>2 || h.order>n) return 0;
+    else used=RGCODEC_COLUMN_HEAD+((n-h.order)*h.width+63)/64*sizeof(uint64_t);
+    return (used<=size) ? used : 0;
+}
+
+//number of samples of the block at p, checked against its byte size: the
+//block must fit into size, hold at most RGCODEC_MAX_BLOCK_SAMPLES samples
+//and consist exactly of its four columns. returns -1 if it is corrupt
+static int check_block(const uint8_t *p, size_t size)
+{
+    uint32_t count;
+    size_t total,pos,used;
+
+    if(size<2*sizeof(uint32_t)) return -1;
+    total=rgcodec::block_size(p);
+    if(total<2*sizeof(uint32_t) || total>size) return -1;
+    memcpy(&count,p+sizeof(uint32_t),sizeof(count));
+    if(count>RGCODEC_MAX_BLOCK_SAMPLES) return -1;
+    pos=2*sizeof(uint32_t);
+    for(int j=0;j<4;j++)
+    {
+        used=column_size(p+pos,total-pos,count);
+        if(used==0) return -1;
+        pos+=used;
+    }
+    return (pos==total) ? (int) count : -1;
+}
+
+//decodes a column of n values at p into c, returns the bytes used or 0 if corrupt
+static size_t decode_column(const uint8_t *p, size_t size, int n, double c[])
+{
+    column_head h;
+    size_t m,words,used;
+    vector<uint64_t> w;
+    vector<int64_t> q;
+
+    used=column_size(p,size,(size_t) n);
+    if(used==0) return 0;
+    memcpy(&h,p,RGCODEC_COLUMN_HEAD);
+    p+=RGCODEC_COLUMN_HEAD;
+    if(h.mode==1)
+    {
+        memcpy(c,p,(size_t) n*sizeof(double));
+        return used;
+    }
+    m=(size_t) (n-h.order);
+    words=(m*h.width+63)/64;
+
+    //unpacking: one pad word makes the loop free of branches
+    w.assign(words+1,0);
+    memcpy(w.data(),p,words*sizeof(uint64_t));
+    q.resize(n);
+    for(int i=0;i<h.order;i++) q[i]=h.head[i];
+    const uint64_t mask=(h.width==64) ? ~(uint64_t) 0 : (((uint64_t) 1<<h.width)-1);
+    const uint64_t *wp=w.data();
+    int64_t *qp=q.data()+h.order;
+    for(size_t j=0;j<m;j++)
+    {
+        size_t bit=j*h.width,word=bit>>6;
+        unsigned off=(unsigned) (bit&63);
+        uint64_t z=(wp[word]>>off)|((wp[word+1]<<(63-off))<<1);
+        qp[j]=unzigzag(z&mask);
+    }
+
+    //inverse differences
+    for(int o=h.order-1;o>=0;o--)
+    {
+        for(int i=o+1;i<n;i++) q[i]+=q[i-1];
+    }
+    for(int i=0;i<n;i++) c[i]=unscale(q[i],h.scale);
+    return used;
+}
+
+size_t rgcodec::encode_block(const samplestore &in, size_t i0, int n, vector<uint8_t> &out)
+///******************************************************************
+/// ENCODE_BLOCK
+/// -----------------------------------------------------------------
+/// appends the block of the samples i0..i0+n-1 of in to out and
+/// returns the number of bytes appended
+/// -----------------------------------------------------------------
+/// in    - IN : samples
+/// i0    - IN : first sample of the block
+/// n     - IN : number of samples
+/// out   - OUT: encoded data
+/// -----------------------------------------------------------------
+{
+    size_t start=out.size();
+    uint32_t size,count=(uint32_t) n;
+    vector<double> c(n);
+
+    put(out,(uint32_t) 0);           //size, set below
+    put(out,count);
+    encode_column(in.times()+i0,n,2,out);
+    for(int j=0;j<3;j++)
+    {
+        in.copy_axis(j,i0,n,c.data());
+        encode_column(c.data(),n,1,out);
+    }
+    size=(uint32_t) (out.size()-start-sizeof(uint32_t));
+    memcpy(&out[start],&size,sizeof(size));
+    return out.size()-start;
+}
+
+size_t rgcodec::block_size(const uint8_t *p)
+///******************************************************************
+/// BLOCK_SIZE
+/// -----------------------------------------------------------------
+/// returns the total size of the block at p (size field included)
+/// -----------------------------------------------------------------
+/// p     - IN : encoded block (at least 4 bytes)
+/// -----------------------------------------------------------------
+{
+    uint32_t size;
+
+    memcpy(&size,p,sizeof(size));
+    return (size_t) size+sizeof(uint32_t);
+}
+
+size_t rgcodec::max_block_bytes(uint32_t n)
+///******************************************************************
+/// MAX_BLOCK_BYTES
+/// -----------------------------------------------------------------
+/// returns the largest total size (size field included) of a valid
+/// block of at most n samples, the bound for a reader which has to
+/// allocate a block before it can be checked
+/// -----------------------------------------------------------------
+/// n     - IN: block size of the file header (samples)
+/// -----------------------------------------------------------------
+{
+    //stored columns (mode 1) are the largest
+    return 2*sizeof(uint32_t)+4*(RGCODEC_COLUMN_HEAD+(size_t) n*sizeof(double));
+}
+
+int rgcodec::check_header(const uint32_t head[])
+///******************************************************************
+/// CHECK_HEADER
+/// -----------------------------------------------------------------
+/// returns 1 if the four words at the start of a file are a valid
+/// header (magic, version, block size within 1 and
+/// RGCODEC_MAX_BLOCK_SAMPLES) and 0 otherwise
+/// -----------------------------------------------------------------
+/// head  - IN: file header
+/// -----------------------------------------------------------------
+{
+    return (head[0]==RGCODEC_MAGIC && head[1]==RGCODEC_VERSION && head[2]>=1 && head[2]<=RGCODEC_MAX_BLOCK_SAMPLES) ? 1 : 0;
+}
+
+int rgcodec::decode_block(const uint8_t *p, size_t size, vector<double> col[])
+///******************************************************************
+/// DECODE_BLOCK
+/// -----------------------------------------------------------------
+/// decodes the block at p (starting with its size field) into the
+/// columns col[0..3] (t,x,y,z) which are resized to the number of
+/// samples. returns the number of samples or -1 if the block is
+/// corrupt resp. longer than size (checked before any allocation)
+/// -----------------------------------------------------------------
+/// p     - IN : encoded block
+/// size  - IN : number of bytes available at p
+/// col   - OUT: decoded columns
+/// -----------------------------------------------------------------
+{
+    int count;
+    size_t total,pos;
+
+    //the sizes are checked before anything is allocated
+    count=check_block(p,size);
+    if(count<0) return -1;
+    total=block_size(p);
+    pos=2*sizeof(uint32_t);
+    for(int j=0;j<4;j++)
+    {
+        col[j].resize(count);
+        pos+=decode_column(p+pos,total-pos,count,col[j].data());
+    }
+    return count;
+}
+
+int rgcodec::is_compressed(const char *fname)
+///******************************************************************
+/// IS_COMPRESSED
+/// -----------------------------------------------------------------
+/// returns 1 if the file fname starts with a valid header and 0
+/// otherwise (also if the file cannot be opened)
+/// -----------------------------------------------------------------
+/// fname - IN: name of the file
+/// -----------------------------------------------------------------
+{
+    uint32_t head[4];
+    FILE *fp;
+    int res=0;
+
+    fp=fopen(fname,"rb");
+    if(fp==NULL) return 0;
+    if(fread(head,sizeof(head),1,fp)==1 && head[0]==RGCODEC_MAGIC && head[1]==RGCODEC_VERSION) res=1;
+    fclose(fp);
+    return res;
+}
+
+long rgcodec::write_file(const char *fname, const samplestore &store)
+///******************************************************************
+/// WRITE_FILE
+/// -----------------------------------------------------------------
+/// writes the samples of store compressed into the file fname and
+/// returns the number of bytes written or -1 on failure
+/// -----------------------------------------------------------------
+/// fname - IN: name of the file
+/// store - IN: samples
+/// -----------------------------------------------------------------
+{
+    uint32_t head[4]={RGCODEC_MAGIC,RGCODEC_VERSION,(uint32_t) block_samples,0};
+    vector<uint8_t> buf;
+    long written;
+    FILE *fp;
+
+    if(block_samples<1 || block_samples>RGCODEC_MAX_BLOCK_SAMPLES) return -1;
+    fp=fopen(fname,"wb");
+    if(fp==NULL) return -1;
+    written=(long) fwrite(head,1,sizeof(head),fp);
+    for(size_t i0=0;i0<store.size();i0+=block_samples)
+    {
+        int n=(int) min((size_t) block_samples,store.size()-i0);
+        buf.clear();
+        encode_block(store,i0,n,buf);
+        written+=(long) fwrite(buf.data(),1,buf.size(),fp);
+    }
+    if(fclose(fp)!=0) return -1;
+    return written;
+}
+
+int rgcodec::read_file(const char *fname, samplestore &store)
+///******************************************************************
+/// READ_FILE
+/// -----------------------------------------------------------------
+/// decodes the compressed file fname into store (the type of the
+/// store is kept) and returns the number of samples,
+/// RGCODEC_ERR_OPEN if the file cannot be opened or
+/// RGCODEC_ERR_CORRUPT if it is corrupt
+/// -----------------------------------------------------------------
+/// fname - IN : name of the file
+/// store - OUT: samples
+/// -----------------------------------------------------------------
+{
+    uint32_t head[4];
+    vector<uint8_t> buf;
+    vector<double> col[4];
+    size_t n=0,size;
+    long bytes;
+    FILE *fp;
+    int res=0;
+
+    store.resize(0);
+    fp=fopen(fname,"rb");
+    if(fp==NULL) return RGCODEC_ERR_OPEN;
+    fseek(fp,0,SEEK_END);
+    bytes=ftell(fp);
+    fseek(fp,0,SEEK_SET);
+    if(bytes<(long) sizeof(head) || fread(head,sizeof(head),1,fp)!=1 || check_header(head)==0)
+    {
+        fclose(fp);
+        return RGCODEC_ERR_CORRUPT;
+    }
+    //one read of the whole content, decoded block by block into the store
+    size=(size_t) bytes-sizeof(head);
+    buf.resize(size);
+    if(fread(buf.data(),1,size,fp)!=size) res=-1;
+    fclose(fp);
+
+    //the blocks give the number of samples: every block is checked against
+    //its byte size, the block size of the header and the end of the file
+    //before the storage is allocated once
+    for(size_t pos=0;pos<size && res==0;pos+=block_size(buf.data()+pos))
+    {
+        int count=check_block(buf.data()+pos,size-pos);
+        if(count<0 || (uint32_t) count>head[2] || n+count>(size_t) INT_MAX) res=-1;
+        else n+=count;
+    }
+    if(res<0) return RGCODEC_ERR_CORRUPT;
+    store.resize(n);
+    n=0;
+    for(size_t pos=0;pos<size && res==0;)
+    {
+        int m=decode_block(buf.data()+pos,size-pos,col);
+        if(m<0 || n+m>store.size()) {res=-1; break;}
+        for(int j=0;j<4;j++) store.set_axis(j-1,n,m,col[j].data());
+        n+=m;
+        pos+=block_size(buf.data()+pos);
+    }
+    if(res<0) {store.resize(0); return RGCODEC_ERR_CORRUPT;}
+    return (int) n;
+}
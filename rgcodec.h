@@ -0,0 +1,161 @@
+//
+// Created by stefan on 30.03.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_RGCODEC_H
+#define PUBLICATION_RECURSIVE_MEAN_RGCODEC_H
+
+#include "samplestore.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+#define RGCODEC_MAGIC 0x43474752u     //"RGGC"
+#define RGCODEC_VERSION 1
+#define RGCODEC_MAX_SCALE 9           //largest decimal scale 10^k tried for a column
+#define RGCODEC_MAX_BLOCK_SAMPLES 65536 //largest number of samples per block (checked by the decoders)
+//error codes of read_file (also returned by expdata::read_file)
+#define RGCODEC_ERR_OPEN -1           //file could not be opened
+#define RGCODEC_ERR_CORRUPT -2        //header or a block is corrupt
+
+//*******************************************************************
+// lossless compression of recordings "t x y z". The samples are cut
+// into independently decodable blocks. Within a block each column is
+// mapped exactly onto integers, if possible, by a decimal scale 10^k
+// (the values of the text files are integer counts resp. time stamps
+// with a few decimals); the time stamps are then stored as delta of
+// delta, the components as deltas, both zigzag coded and bit-packed
+// with the width of the largest value of the block. Columns which
+// cannot be mapped exactly are stored as raw doubles, so decoding
+// always reproduces the parsed doubles bit by bit.
+//
+// file : header {magic, version, block_samples, reserved} (uint32)
+//        followed by the blocks
+// block: uint32 size of the rest of the block, uint32 n, 4 columns
+// column: uint8 mode (0 packed, 1 raw), uint8 scale k, uint8 width,
+//        uint8 order of the differences, uint32 reserved, int64 head[2]
+//        (the first order values) and the packed words resp. n raw
+//        doubles. All fields are stored in host order (little endian).
+//*******************************************************************
+
+class rgcodec {
+
+public:
+
+    int block_samples=4096;           //samples per block (at most RGCODEC_MAX_BLOCK_SAMPLES)
+
+    ///******************************************************************
+    /// ENCODE_BLOCK
+    /// -----------------------------------------------------------------
+    /// appends the block of the samples i0..i0+n-1 of in to out and
+    /// returns the number of bytes appended
+    /// -----------------------------------------------------------------
+    /// in    - IN : samples
+    /// i0    - IN : first sample of the block
+    /// n     - IN : number of samples
+    /// out   - OUT: encoded data
+    /// -----------------------------------------------------------------
+
+    static size_t encode_block(const samplestore &in, size_t i0, int n, vector<uint8_t> &out);
+
+    ///******************************************************************
+    /// DECODE_BLOCK
+    /// -----------------------------------------------------------------
+    /// decodes the block at p (starting with its size field) into the
+    /// columns col[0..3] (t,x,y,z) which are resized to the number of
+    /// samples. returns the number of samples or -1 if the block is
+    /// corrupt resp. longer than size
+    /// -----------------------------------------------------------------
+    /// p     - IN : encoded block
+    /// size  - IN : number of bytes available at p
+    /// col   - OUT: decoded columns
+    /// -----------------------------------------------------------------
+
+    static int decode_block(const uint8_t *p, size_t size, vector<double> col[]);
+
+    ///******************************************************************
+    /// BLOCK_SIZE
+    /// -----------------------------------------------------------------
+    /// returns the total size of the block at p (size field included)
+    /// -----------------------------------------------------------------
+    /// p     - IN : encoded block (at least 4 bytes)
+    /// -----------------------------------------------------------------
+
+    static size_t block_size(const uint8_t *p);
+
+    ///******************************************************************
+    /// MAX_BLOCK_BYTES
+    /// -----------------------------------------------------------------
+    /// returns the largest total size (size field included) of a valid
+    /// block of at most n samples, the bound for a reader which has to
+    /// allocate a block before it can be checked
+    /// -----------------------------------------------------------------
+    /// n     - IN: block size of the file header (samples)
+    /// -----------------------------------------------------------------
+
+    static size_t max_block_bytes(uint32_t n);
+
+    ///******************************************************************
+    /// CHECK_HEADER
+    /// -----------------------------------------------------------------
+    /// returns 1 if the four words at the start of a file are a valid
+    /// header (magic, version, block size within 1 and
+    /// RGCODEC_MAX_BLOCK_SAMPLES) and 0 otherwise
+    /// -----------------------------------------------------------------
+    /// head  - IN: file header
+    /// -----------------------------------------------------------------
+
+    static int check_header(const uint32_t head[]);
+
+    ///******************************************************************
+    /// IS_COMPRESSED
+    /// -----------------------------------------------------------------
+    /// returns 1 if the file fname starts with a valid header and 0
+    /// otherwise (also if the file cannot be opened)
+    /// -----------------------------------------------------------------
+    /// fname - IN: name of the file
+    /// -----------------------------------------------------------------
+
+    static int is_compressed(const char *fname);
+
+    ///******************************************************************
+    /// WRITE_FILE
+    /// -----------------------------------------------------------------
+    /// writes the samples of store compressed into the file fname and
+    /// returns the number of bytes written or -1 on failure
+    /// -----------------------------------------------------------------
+    /// fname - IN: name of the file
+    /// store - IN: samples
+    /// -----------------------------------------------------------------
+
+    long write_file(const char *fname, const samplestore &store);
+
+    ///******************************************************************
+    /// READ_FILE
+    /// -----------------------------------------------------------------
+    /// decodes the compressed file fname into store (the type of the
+    /// store is kept) and returns the number of samples,
+    /// RGCODEC_ERR_OPEN if the file cannot be opened or
+    /// RGCODEC_ERR_CORRUPT if it is corrupt
+    /// -----------------------------------------------------------------
+    /// fname - IN : name of the file
+    /// store - OUT: samples
+    /// -----------------------------------------------------------------
+
+    static int read_file(const char *fname, samplestore &store);
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_RGCODEC_H
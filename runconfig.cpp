@@ -0,0 +1,323 @@
+//
+// Created by stefan on 08.06.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "runconfig.h"
+#include "expdata.h"
+#include "rgcodec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fstream>
+
+static const char *keys[]={"prop","fractional","static-time","min-runs","rng","seed","threads",
+                           "gyro","acc","input","engine","output","repeat","fgrid","pgrid",
+                           "trace","trace-capacity","trace-drop","metrics","robust","decimate","storage"};
+static const char *flags[]={"trace-drop"};
+static const char *inputs[]={"auto","text","rgc"};
+static const char *engines[]={"scalar","batched","streaming"};
+static const char *outputs[]={"text","csv","json"};
+static const char *storages[]={"double","float","int32"};  //in the order of sample_type
+static const char *switches[]={"off","on"};
+static const int nkeys=(int) (sizeof(keys)/sizeof(keys[0]));
+static const int nflags=(int) (sizeof(flags)/sizeof(flags[0]));
+
+//index of name in names[0..n-1] or -1
+static int lookup(const char *name, const char *names[], int n)
+{
+    for(int k=0;k<n;k++) if(strcmp(name,names[k])==0) return k;
+    return -1;
+}
+
+//number in value (the whole text), 0 if it is none
+static int to_double(const char *value, double &x)
+{
+    char *end;
+
+    x=strtod(value,&end);
+    return (end!=value && *end=='\0') ? 1 : 0;
+}
+
+static int to_long(const char *value, long &x)
+{
+    char *end;
+
+    x=strtol(value,&end,10);
+    return (end!=value && *end=='\0') ? 1 : 0;
+}
+
+//comma separated numbers in value, each within (lo,hi); 0 if one is none
+static int to_list(const char *value, double lo, double hi, vector<double> &list)
+{
+    char *end;
+    vector<double> v;
+
+    for(const char *c=value;;c=end+1)
+    {
+        v.push_back(strtod(c,&end));
+        if(end==c || !(v.back()>lo && v.back()<hi)) return 0;
+        if(*end=='\0') break;
+        if(*end!=',') return 0;
+    }
+    list=v;
+    return 1;
+}
+
+int runconfig::set(const char *key, const char *value)
+///******************************************************************
+/// SET
+/// -----------------------------------------------------------------
+/// sets the parameter key to value. returns 1 on success, 0 if the
+/// value is invalid and -1 if key is not a parameter
+/// -----------------------------------------------------------------
+/// key   - IN: name of the parameter (long option without "--")
+/// value - IN: value as text
+/// -----------------------------------------------------------------
+{
+    int k=lookup(key,keys,nkeys),ok=0;
+    double d;
+    long l;
+
+    if(k<0) return -1;
+    //in the order of keys
+    switch(k)
+    {
+        case 0: ok=to_double(value,d) && d>0.0 && d<1.0; if(ok) prop=d; break;
+        case 1: ok=to_double(value,d) && d>0.0; if(ok) fractional=d; break;
+        case 2: ok=to_double(value,d) && d>0.0; if(ok) static_time=d; break;
+        case 3: ok=to_long(value,l) && l>=1; if(ok) min_runs=(int) l; break;
+        case 4:
+            if(strcmp(value,"short")==0) value="1";
+            else if(strcmp(value,"long")==0) value="2";
+            ok=to_long(value,l) && (l==1 || l==2);
+            if(ok) rng=(int) l;
+            break;
+        case 5: ok=to_long(value,l) && l>=1; if(ok) seed=l; break;
+        case 6: ok=to_long(value,l) && l>=0; if(ok) threads=(int) l; break;
+        case 7: ok=(value[0]!='\0'); if(ok) gyro=value; break;
+        case 8: ok=(value[0]!='\0'); if(ok) acc=value; break;
+        case 9: ok=((l=lookup(value,inputs,3))>=0); if(ok) input=(int) l; break;
+        case 10: ok=((l=lookup(value,engines,3))>=0); if(ok) engine=(int) l; break;
+        case 11: ok=((l=lookup(value,outputs,3))>=0); if(ok) output=(int) l; break;
+        case 12: ok=to_long(value,l) && l>=1; if(ok) repeat=(int) l; break;
+        case 13: ok=to_list(value,0.0,HUGE_VAL,fgrid); break;
+        case 14: ok=to_list(value,0.0,1.0,pgrid); break;
+        case 15: ok=(value[0]!='\0'); if(ok) trace=value; break;
+        case 16: ok=to_long(value,l) && l>=1; if(ok) trace_capacity=l; break;
+        case 17: ok=((l=lookup(value,switches,2))>=0); if(ok) trace_drop=(l==1); break;
+        case 18: ok=(value[0]!='\0'); if(ok) metrics=value; break;
+        case 19: ok=to_double(value,d) && d>=0.0; if(ok) robust=d; break;
+        case 20: ok=to_long(value,l) && l>=1; if(ok) decimate=(int) l; break;
+        default: ok=((l=lookup(value,storages,3))>=0); if(ok) storage=(sample_type) l; break;
+    }
+    if(!ok) printf("invalid value for %s: %s\n",key,value);
+    else given|=1u<<k;
+    return ok;
+}
+
+int runconfig::read(const char *fname)
+///******************************************************************
+/// READ
+/// -----------------------------------------------------------------
+/// sets the parameters from the configuration file fname ("key =
+/// value" per line). returns 1 on success and 0 if the file could
+/// not be read or contains an unknown key or an invalid value
+/// -----------------------------------------------------------------
+/// fname - IN: name of the configuration file
+/// -----------------------------------------------------------------
+{
+    ifstream in(fname);
+    string line;
+    int nline=0;
+
+    if(!in)
+    {
+        printf("could not read configuration file: %s\n",fname);
+        return 0;
+    }
+    while(getline(in,line))
+    {
+        size_t c=line.find('#'),eq;
+        string key,value;
+
+        nline++;
+        if(c!=string::npos) line.erase(c);
+        if(line.find_first_not_of(" \t\r")==string::npos) continue;
+        eq=line.find('=');
+        if(eq==string::npos)
+        {
+            printf("%s:%d: expected key = value\n",fname,nline);
+            return 0;
+        }
+        key=line.substr(0,eq);
+        value=line.substr(eq+1);
+        //trim blanks around key and value
+        key.erase(0,key.find_first_not_of(" \t"));
+        key.erase(key.find_last_not_of(" \t\r")+1);
+        value.erase(0,value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t\r")+1);
+        int res=set(key.c_str(),value.c_str());
+        if(res<0) printf("%s:%d: unknown key: %s\n",fname,nline,key.c_str());
+        if(res<=0) return 0;
+    }
+    return 1;
+}
+
+bool runconfig::is_option(const char *arg)
+///******************************************************************
+/// IS_OPTION
+/// -----------------------------------------------------------------
+/// returns true if arg is "--config" or "--key" of a parameter,
+/// i.e. an option which parse takes over (with its value unless it
+/// is a flag)
+/// -----------------------------------------------------------------
+/// arg   - IN: command line argument
+/// -----------------------------------------------------------------
+{
+    if(strncmp(arg,"--",2)!=0) return false;
+    return strcmp(arg+2,"config")==0 || lookup(arg+2,keys,nkeys)>=0;
+}
+
+bool runconfig::is_flag(const char *arg)
+///******************************************************************
+/// IS_FLAG
+/// -----------------------------------------------------------------
+/// returns true if arg is "--key" of a flag, an option which takes
+/// no value on the command line
+/// -----------------------------------------------------------------
+/// arg   - IN: command line argument
+/// -----------------------------------------------------------------
+{
+    return strncmp(arg,"--",2)==0 && lookup(arg+2,flags,nflags)>=0;
+}
+
+int runconfig::parse(int argc, char *argv[])
+///******************************************************************
+/// PARSE
+/// -----------------------------------------------------------------
+/// takes over "--config <file>", every "--key value" of a parameter
+/// and every "--key" of a flag from the command line, in order; other
+/// arguments are left to the caller. returns 1 on success and 0 on an
+/// error
+/// -----------------------------------------------------------------
+/// argc  - IN: number of arguments
+/// argv  - IN: arguments
+/// -----------------------------------------------------------------
+{
+    for(int k=1;k<argc;k++)
+    {
+        if(!is_option(argv[k])) continue;
+        if(is_flag(argv[k]))
+        {
+            set(argv[k]+2,"on");
+            given_cmdline|=1u<<lookup(argv[k]+2,keys,nkeys);
+            continue;
+        }
+        if(k+1>=argc)
+        {
+            printf("missing value for %s\n",argv[k]);
+            return 0;
+        }
+        if(strcmp(argv[k],"--config")==0) {if(read(argv[k+1])==0) return 0;}
+        else
+        {
+            if(set(argv[k]+2,argv[k+1])==0) return 0;
+            given_cmdline|=1u<<lookup(argv[k]+2,keys,nkeys);
+        }
+        k++;
+    }
+    return 1;
+}
+
+int runconfig::apply() const
+///******************************************************************
+/// APPLY
+/// -----------------------------------------------------------------
+/// hands the data files and their format to expdata (gyro_name,
+/// acc_name, input_format) and checks the gyroscopic file (and the acceleration file if it
+/// is given) against the selected input format. returns 1 on success
+/// and 0 if a file does not have the selected format
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+{
+    char fname[2][150];
+
+    expdata::gyro_name=gyro.empty() ? nullptr : gyro.c_str();
+    expdata::acc_name=acc.empty() ? nullptr : acc.c_str();
+    expdata::input_format=input;
+    if(input==EXPDATA_INPUT_AUTO) return 1;
+
+    //the gyroscopic file and an explicitly given acceleration file are
+    //checked if they exist, missing ones are reported on loading
+    expdata::read_names(fname[0],fname[1]);
+    for(int k=(acc.empty() ? 1 : 0);k<2;k++)
+    {
+        ifstream probe(fname[k]);
+        if(fname[k][0]=='\0' || !probe) continue;
+        if(rgcodec::is_compressed(fname[k])!=(input==EXPDATA_INPUT_RGC ? 1 : 0))
+        {
+            printf("file %s is not in the selected input format %s\n",fname[k],inputs[input]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+bool runconfig::is_set(const char *key) const
+///******************************************************************
+/// IS_SET
+/// -----------------------------------------------------------------
+/// returns true if the parameter key has been set, from the command
+/// line or from a configuration file
+/// -----------------------------------------------------------------
+/// key   - IN: name of the parameter (long option without "--")
+/// -----------------------------------------------------------------
+{
+    int k=lookup(key,keys,nkeys);
+
+    return k>=0 && (given&(1u<<k))!=0;
+}
+
+int runconfig::check_used(const char *mode, const char *used) const
+///******************************************************************
+/// CHECK_USED
+/// -----------------------------------------------------------------
+/// returns 1 if every parameter set on the command line is among the
+/// blank separated keys in used, otherwise reports the first one
+/// which the mode does not use and returns 0
+/// -----------------------------------------------------------------
+/// mode  - IN: name of the mode (for the report)
+/// used  - IN: keys used by the mode, separated by blanks
+/// -----------------------------------------------------------------
+{
+    string list=string(" ")+used+" ";
+
+    for(int k=0;k<nkeys;k++)
+    {
+        if((given_cmdline&(1u<<k))==0) continue;
+        if(list.find(string(" ")+keys[k]+" ")==string::npos)
+        {
+            printf("option --%s is not used by the mode %s\n",keys[k],mode);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+const char *runconfig::engine_name() const
+{
+    return engines[engine];
+}
@@ -0,0 +1,188 @@
+//
+// Created by stefan on 08.06.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_RUNCONFIG_H
+#define PUBLICATION_RECURSIVE_MEAN_RUNCONFIG_H
+
+#include <string>
+#include <vector>
+#include "expdata.h"
+using namespace std;
+
+//engine of the mode "run"
+#define RUNCONFIG_ENGINE_SCALAR 0     //recstat::seq_update per component and sample (main.cpp)
+#define RUNCONFIG_ENGINE_BATCHED 1    //multichan, components as channels with early retirement
+#define RUNCONFIG_ENGINE_STREAMING 2  //calibrator of librecgyro, one push per sample
+//format of the results of the mode "run"
+#define RUNCONFIG_OUTPUT_TEXT 0
+#define RUNCONFIG_OUTPUT_CSV 1
+#define RUNCONFIG_OUTPUT_JSON 2
+
+//*******************************************************************
+// parameters of a run which used to be compiled into main() or taken
+// from the file "dnames": the operating point, the length of the
+// static period, the minimum number of runs, the random number
+// generator, the data files and their format, the number of threads
+// and, for the mode "run", the engine, the format of the results and
+// the number of timed repetitions, for the mode "sweep" the grid of
+// operating points (comma separated lists), the type of the stored
+// components, the metrics file and, for the run without a mode, the
+// trace, the robust gate and the decimation. The defaults are the values of
+// the publication, such that a run without options is unchanged.
+// Values are set by key (the long option without "--"): from the
+// command line as "--key value" (a flag such as trace-drop as "--key"
+// alone) or from a configuration file with one "key = value" per line
+// (a flag as "key = on" or "key = off", '#' starts a comment), later settings
+// override earlier ones. Modes with an operating point of their own
+// use it unless the key is set (is_set), and a mode rejects keys from
+// the command line which it does not use (check_used), a configuration
+// file may be shared by all modes.
+//*******************************************************************
+
+class runconfig {
+
+private:
+
+    unsigned given=0;         //bit k: keys[k] has been set
+    unsigned given_cmdline=0; //bit k: keys[k] has been set on the command line
+
+public:
+
+    double prop=0.9;          //acceptance probability (prop_chosen)
+    double fractional=0.005;  //fractional accuracy (fractional_chosen)
+    double static_time=50.0;  //length of the initial static period in s
+    int min_runs=100;         //minimum number of runs
+    int rng=1;                //random number generator (1: short, 2: long period)
+    long seed=1;              //seed of the random number generator
+    int threads=0;            //threads for loading and static calibration (0: all cores)
+    string gyro;              //gyroscopic data file (empty: from "dnames")
+    string acc;               //acceleration data file (empty: from "dnames")
+    int input=EXPDATA_INPUT_AUTO;     //format of the data files (expdata::input_format)
+    int engine=RUNCONFIG_ENGINE_SCALAR;
+    int output=RUNCONFIG_OUTPUT_TEXT;
+    int repeat=1;             //timed repetitions of the mode "run"
+    vector<double> fgrid={5.0e-5,1.0e-4,2.0e-4,1.0e-3,5.0e-3}; //fractional accuracies of the mode "sweep"
+    vector<double> pgrid={0.5,0.8,0.9,0.99,0.999};            //acceptance probabilities of the mode "sweep"
+    string trace;             //trace file of the recursion (empty: no trace)
+    long trace_capacity=1<<16;//records of the ring buffer of the trace
+    bool trace_drop=false;    //drop trace records instead of waiting when the ring is full
+    string metrics;           //metrics file (empty: no metrics)
+    double robust=0.0;        //gate of seq_update_robust in standard deviations (0: seq_update)
+    int decimate=1;           //samples averaged before they enter the recursion
+    sample_type storage=SAMPLE_DOUBLE; //type of the stored components
+
+    ///******************************************************************
+    /// SET
+    /// -----------------------------------------------------------------
+    /// sets the parameter key to value. returns 1 on success, 0 if the
+    /// value is invalid and -1 if key is not a parameter
+    /// -----------------------------------------------------------------
+    /// key   - IN: name of the parameter (long option without "--")
+    /// value - IN: value as text
+    /// -----------------------------------------------------------------
+
+    int set(const char *key, const char *value);
+
+    ///******************************************************************
+    /// READ
+    /// -----------------------------------------------------------------
+    /// sets the parameters from the configuration file fname ("key =
+    /// value" per line). returns 1 on success and 0 if the file could
+    /// not be read or contains an unknown key or an invalid value
+    /// -----------------------------------------------------------------
+    /// fname - IN: name of the configuration file
+    /// -----------------------------------------------------------------
+
+    int read(const char *fname);
+
+    ///******************************************************************
+    /// PARSE
+    /// -----------------------------------------------------------------
+    /// takes over "--config <file>", every "--key value" of a parameter
+    /// and every "--key" of a flag from the command line, in order; other
+    /// arguments are left to the caller. returns 1 on success and 0 on an
+    /// error
+    /// -----------------------------------------------------------------
+    /// argc  - IN: number of arguments
+    /// argv  - IN: arguments
+    /// -----------------------------------------------------------------
+
+    int parse(int argc, char *argv[]);
+
+    ///******************************************************************
+    /// IS_OPTION
+    /// -----------------------------------------------------------------
+    /// returns true if arg is "--config" or "--key" of a parameter,
+    /// i.e. an option which parse takes over (with its value unless it
+    /// is a flag)
+    /// -----------------------------------------------------------------
+    /// arg   - IN: command line argument
+    /// -----------------------------------------------------------------
+
+    static bool is_option(const char *arg);
+
+    ///******************************************************************
+    /// IS_FLAG
+    /// -----------------------------------------------------------------
+    /// returns true if arg is "--key" of a flag, an option which takes
+    /// no value on the command line
+    /// -----------------------------------------------------------------
+    /// arg   - IN: command line argument
+    /// -----------------------------------------------------------------
+
+    static bool is_flag(const char *arg);
+
+    ///******************************************************************
+    /// APPLY
+    /// -----------------------------------------------------------------
+    /// hands the data files and their format to expdata (gyro_name,
+    /// acc_name, input_format) and checks the gyroscopic file (and the acceleration file if it
+    /// is given) against the selected input format. returns 1 on success
+    /// and 0 if a file does not have the selected format
+    /// -----------------------------------------------------------------
+    /// no input arguments
+    /// -----------------------------------------------------------------
+
+    int apply() const;
+
+    ///******************************************************************
+    /// IS_SET
+    /// -----------------------------------------------------------------
+    /// returns true if the parameter key has been set, from the command
+    /// line or from a configuration file
+    /// -----------------------------------------------------------------
+    /// key   - IN: name of the parameter (long option without "--")
+    /// -----------------------------------------------------------------
+
+    bool is_set(const char *key) const;
+
+    ///******************************************************************
+    /// CHECK_USED
+    /// -----------------------------------------------------------------
+    /// returns 1 if every parameter set on the command line is among the
+    /// blank separated keys in used, otherwise reports the first one
+    /// which the mode does not use and returns 0
+    /// -----------------------------------------------------------------
+    /// mode  - IN: name of the mode (for the report)
+    /// used  - IN: keys used by the mode, separated by blanks
+    /// -----------------------------------------------------------------
+
+    int check_used(const char *mode, const char *used) const;
+
+    const char *engine_name() const;
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_RUNCONFIG_H
@@ -0,0 +1,173 @@
+//
+// Created by stefan on 23.03.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "samplestore.h"
+#include <math.h>
+
+void samplestore::set_type(sample_type st)
+///******************************************************************
+/// SET_TYPE
+/// -----------------------------------------------------------------
+/// selects the storage type of the components, the store is emptied
+/// -----------------------------------------------------------------
+/// st    - IN: storage type
+/// -----------------------------------------------------------------
+{
+    resize(0);
+    for(int j=0;j<3;j++)
+    {
+        vector<double>().swap(vd[j]);
+        vector<float>().swap(vf[j]);
+        vector<int32_t>().swap(vi[j]);
+    }
+    type=st;
+}
+
+void samplestore::resize(size_t size)
+///******************************************************************
+/// RESIZE
+/// -----------------------------------------------------------------
+/// sets the number of samples, new samples are 0
+/// -----------------------------------------------------------------
+/// size  - IN: number of samples
+/// -----------------------------------------------------------------
+{
+    n=size;
+    t.resize(n);
+    for(int j=0;j<3;j++)
+    {
+        if(type==SAMPLE_DOUBLE) vd[j].resize(n);
+        else if(type==SAMPLE_FLOAT) vf[j].resize(n);
+        else vi[j].resize(n);
+    }
+}
+
+void samplestore::set(size_t i, double ti, double x, double y, double z)
+///******************************************************************
+/// SET
+/// -----------------------------------------------------------------
+/// stores the sample i (converted to the storage type)
+/// -----------------------------------------------------------------
+/// i     - IN: index of the sample
+/// ti    - IN: time stamp
+/// x,y,z - IN: components
+/// -----------------------------------------------------------------
+{
+    double v[3]={x,y,z};
+
+    t[i]=ti;
+    for(int j=0;j<3;j++)
+    {
+        if(type==SAMPLE_DOUBLE) vd[j][i]=v[j];
+        else if(type==SAMPLE_FLOAT) vf[j][i]=(float) v[j];
+        else vi[j][i]=(int32_t) lround(v[j]);
+    }
+}
+
+void samplestore::copy_sample(size_t to, size_t from)
+///******************************************************************
+/// COPY_SAMPLE
+/// -----------------------------------------------------------------
+/// copies the sample from onto the sample to (all columns)
+/// -----------------------------------------------------------------
+/// to    - IN: index of the destination
+/// from  - IN: index of the source
+/// -----------------------------------------------------------------
+{
+    t[to]=t[from];
+    for(int j=0;j<3;j++)
+    {
+        if(type==SAMPLE_DOUBLE) vd[j][to]=vd[j][from];
+        else if(type==SAMPLE_FLOAT) vf[j][to]=vf[j][from];
+        else vi[j][to]=vi[j][from];
+    }
+}
+
+void samplestore::copy_axis(int j, size_t i0, size_t count, double out[]) const
+///******************************************************************
+/// COPY_AXIS
+/// -----------------------------------------------------------------
+/// converts the samples i0..i0+count-1 of component j into out
+/// -----------------------------------------------------------------
+/// j     - IN : component (0: x, 1: y, 2: z)
+/// i0    - IN : first sample
+/// count - IN : number of samples
+/// out   - OUT: values
+/// -----------------------------------------------------------------
+{
+    //one loop per type: contiguous and free of branches
+    if(type==SAMPLE_DOUBLE)
+    {
+        const double *p=vd[j].data()+i0;
+        for(size_t i=0;i<count;i++) out[i]=p[i];
+    }
+    else if(type==SAMPLE_FLOAT)
+    {
+        const float *p=vf[j].data()+i0;
+        for(size_t i=0;i<count;i++) out[i]=(double) p[i];
+    }
+    else
+    {
+        const int32_t *p=vi[j].data()+i0;
+        for(size_t i=0;i<count;i++) out[i]=(double) p[i];
+    }
+}
+
+void samplestore::set_axis(int j, size_t i0, size_t count, const double in[])
+///******************************************************************
+/// SET_AXIS
+/// -----------------------------------------------------------------
+/// stores in[0..count-1] as the samples i0.. of component j (j=-1
+/// for the time stamps), converted to the storage type
+/// -----------------------------------------------------------------
+/// j     - IN: component (-1: t, 0: x, 1: y, 2: z)
+/// i0    - IN: first sample
+/// count - IN: number of samples
+/// in    - IN: values
+/// -----------------------------------------------------------------
+{
+    if(j<0)
+    {
+        double *p=t.data()+i0;
+        for(size_t i=0;i<count;i++) p[i]=in[i];
+    }
+    else if(type==SAMPLE_DOUBLE)
+    {
+        double *p=vd[j].data()+i0;
+        for(size_t i=0;i<count;i++) p[i]=in[i];
+    }
+    else if(type==SAMPLE_FLOAT)
+    {
+        float *p=vf[j].data()+i0;
+        for(size_t i=0;i<count;i++) p[i]=(float) in[i];
+    }
+    else
+    {
+        int32_t *p=vi[j].data()+i0;
+        for(size_t i=0;i<count;i++) p[i]=(int32_t) lround(in[i]);
+    }
+}
+
+size_t samplestore::memory() const
+///******************************************************************
+/// MEMORY
+/// -----------------------------------------------------------------
+/// returns the number of bytes used by the samples
+/// -----------------------------------------------------------------
+{
+    size_t w=(type==SAMPLE_DOUBLE) ? sizeof(double) : 4;
+
+    return n*(sizeof(double)+3*w);
+}
@@ -0,0 +1,147 @@
+//
+// Created by stefan on 23.03.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_SAMPLESTORE_H
+#define PUBLICATION_RECURSIVE_MEAN_SAMPLESTORE_H
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+using namespace std;
+
+//storage type of the three value columns
+enum sample_type
+{
+    SAMPLE_DOUBLE=0,        //64 bit floating point (default)
+    SAMPLE_FLOAT,           //32 bit floating point
+    SAMPLE_INT32            //32 bit integer, e.g. raw ADC counts (values are rounded)
+};
+
+//*******************************************************************
+// columnar storage of a time series "t x y z": the time stamps and
+// each of the three components are kept in separate contiguous
+// arrays, so a scan over one component does not pull the others into
+// the cache. The time stamps are always stored as double (they are
+// searched by mathb::locate), the components as double, float or
+// int32. All storage is owned by the object.
+//*******************************************************************
+
+class samplestore {
+
+private:
+
+    sample_type type=SAMPLE_DOUBLE;
+    size_t n=0;
+    vector<double> t;          //time stamps
+    vector<double> vd[3];      //components, only the columns of type are used
+    vector<float> vf[3];
+    vector<int32_t> vi[3];
+
+public:
+
+    ///******************************************************************
+    /// SET_TYPE
+    /// -----------------------------------------------------------------
+    /// selects the storage type of the components, the store is emptied
+    /// -----------------------------------------------------------------
+    /// st    - IN: storage type
+    /// -----------------------------------------------------------------
+
+    void set_type(sample_type st);
+
+    ///******************************************************************
+    /// RESIZE
+    /// -----------------------------------------------------------------
+    /// sets the number of samples, new samples are 0
+    /// -----------------------------------------------------------------
+    /// size  - IN: number of samples
+    /// -----------------------------------------------------------------
+
+    void resize(size_t size);
+
+    ///******************************************************************
+    /// SET
+    /// -----------------------------------------------------------------
+    /// stores the sample i (converted to the storage type)
+    /// -----------------------------------------------------------------
+    /// i     - IN: index of the sample
+    /// ti    - IN: time stamp
+    /// x,y,z - IN: components
+    /// -----------------------------------------------------------------
+
+    void set(size_t i, double ti, double x, double y, double z);
+
+    ///******************************************************************
+    /// COPY_SAMPLE
+    /// -----------------------------------------------------------------
+    /// copies the sample from onto the sample to (all columns)
+    /// -----------------------------------------------------------------
+    /// to    - IN: index of the destination
+    /// from  - IN: index of the source
+    /// -----------------------------------------------------------------
+
+    void copy_sample(size_t to, size_t from);
+
+    ///******************************************************************
+    /// COPY_AXIS
+    /// -----------------------------------------------------------------
+    /// converts the samples i0..i0+count-1 of component j into out
+    /// -----------------------------------------------------------------
+    /// j     - IN : component (0: x, 1: y, 2: z)
+    /// i0    - IN : first sample
+    /// count - IN : number of samples
+    /// out   - OUT: values
+    /// -----------------------------------------------------------------
+
+    void copy_axis(int j, size_t i0, size_t count, double out[]) const;
+
+    ///******************************************************************
+    /// SET_AXIS
+    /// -----------------------------------------------------------------
+    /// stores in[0..count-1] as the samples i0.. of component j (j=-1
+    /// for the time stamps), converted to the storage type
+    /// -----------------------------------------------------------------
+    /// j     - IN: component (-1: t, 0: x, 1: y, 2: z)
+    /// i0    - IN: first sample
+    /// count - IN: number of samples
+    /// in    - IN: values
+    /// -----------------------------------------------------------------
+
+    void set_axis(int j, size_t i0, size_t count, const double in[]);
+
+    ///******************************************************************
+    /// MEMORY
+    /// -----------------------------------------------------------------
+    /// returns the number of bytes used by the samples
+    /// -----------------------------------------------------------------
+
+    size_t memory() const;
+
+    size_t size() const {return n;}
+    sample_type storage() const {return type;}
+    const double *times() const {return t.data();}
+    double time(size_t i) const {return t[i];}
+
+    //component j of sample i
+    double get(int j, size_t i) const
+    {
+        if(type==SAMPLE_DOUBLE) return vd[j][i];
+        if(type==SAMPLE_FLOAT) return (double) vf[j][i];
+        return (double) vi[j][i];
+    }
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_SAMPLESTORE_H
@@ -0,0 +1,255 @@
+//
+// Created by stefan on 09.03.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "tempcache.h"
+#include "recstats.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+tempcache::tempcache() : version(0)
+{
+}
+
+void tempcache::setup(double t0, double w, int nb)
+///******************************************************************
+/// SETUP
+/// -----------------------------------------------------------------
+/// creates nb empty bins of width w starting at temperature t0
+/// -----------------------------------------------------------------
+/// t0    - IN: lower edge of the first bin
+/// w     - IN: width of the bins
+/// nb    - IN: number of bins
+/// -----------------------------------------------------------------
+{
+    tmin=t0;
+    width=w;
+    nbins=nb;
+    bins.assign(nbins,bin());
+    off.reset(new atomic<double>[3*nbins]);
+    below.reset(new atomic<int>[nbins]);
+    above.reset(new atomic<int>[nbins]);
+    for(int b=0;b<nbins;b++)
+    {
+        memset(bins[b].stat,0,sizeof(bins[b].stat));
+        bins[b].n=0;
+        bins[b].converged=0;
+        for(int j=0;j<3;j++) off[3*b+j].store(0.0);
+        below[b].store(-1);
+        above[b].store(-1);
+    }
+    version.store(0);
+}
+
+int tempcache::bin_index(double temp)
+///******************************************************************
+/// BIN_INDEX
+/// -----------------------------------------------------------------
+/// returns the bin of the temperature temp (clamped to the table)
+/// -----------------------------------------------------------------
+/// temp  - IN: temperature
+/// -----------------------------------------------------------------
+{
+    int b=(int) floor((temp-tmin)/width);
+
+    if(b<0) return 0;
+    if(b>=nbins) return nbins-1;
+    return b;
+}
+
+void tempcache::publish(int b)
+///******************************************************************
+/// PUBLISH
+/// -----------------------------------------------------------------
+/// stores the offsets of the newly converged bin b and updates the
+/// nearest converged neighbours of the bins around it
+/// -----------------------------------------------------------------
+{
+    unsigned v=version.load(memory_order_relaxed);
+
+    version.store(v+1,memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for(int j=0;j<3;j++) off[3*b+j].store(bins[b].stat[j][2],memory_order_relaxed);
+    //b becomes the nearest converged bin below for all bins up to the next converged one
+    for(int k=b;k<nbins && (k==b || !bins[k].converged);k++) below[k].store(b,memory_order_relaxed);
+    for(int k=b;k>=0 && (k==b || !bins[k].converged);k--) above[k].store(b,memory_order_relaxed);
+
+    version.store(v+2,memory_order_release);
+}
+
+int tempcache::update(double temp, const double x[])
+///******************************************************************
+/// UPDATE
+/// -----------------------------------------------------------------
+/// feeds the sample x[0..2] into the recursion of the bin of the
+/// temperature temp unless that bin has already converged. returns
+/// 1 if the bin converged with this sample and 0 otherwise
+/// -----------------------------------------------------------------
+/// temp  - IN: temperature of the sample
+/// x     - IN: gyroscopic sample (three components)
+/// -----------------------------------------------------------------
+{
+    recstat recstats;
+    double min=1.1,p;
+    int b=bin_index(temp);
+    bin &bn=bins[b];
+
+    if(bn.converged) return 0;
+
+    bn.n++;
+    for(int j=0;j<3;j++)
+    {
+        recstats.seq_update(bn.stat[j],x[j],bn.n);
+        p=recstats.seq_accept_probability(bn.stat[j],fractional_chosen);
+        if(min>=p) min=p;
+    }
+    //same criterion as in main.cpp (the run counter there is n+1)
+    if(min<prop_chosen || bn.n+1<min_runs) return 0;
+
+    bn.converged=1;
+    publish(b);
+    return 1;
+}
+
+int tempcache::lookup(double temp, double offset[])
+///******************************************************************
+/// LOOKUP
+/// -----------------------------------------------------------------
+/// returns the offsets for the temperature temp: the offsets of its
+/// bin if it has converged, otherwise interpolated between (or taken
+/// from) the nearest converged bins. returns 1 if the bin itself is
+/// converged, 2 if interpolated resp. extrapolated and 0 if no bin
+/// has converged yet. O(1), lock-free and without allocation
+/// -----------------------------------------------------------------
+/// temp  - IN : temperature
+/// offset- OUT: offsets of the three components
+/// -----------------------------------------------------------------
+{
+    unsigned v1,v2;
+    int b=bin_index(temp),lo,hi,res;
+    double w,tlo;
+
+    do
+    {
+        v1=version.load(memory_order_acquire);
+        if(v1&1u) continue;
+
+        lo=below[b].load(memory_order_relaxed);
+        hi=above[b].load(memory_order_relaxed);
+        if(lo<0 && hi<0) res=0;
+        else if(lo==b || hi==b || lo<0 || hi<0)
+        {
+            //own bin or only one converged neighbour: no interpolation
+            if(lo<0) lo=hi;
+            for(int j=0;j<3;j++) offset[j]=off[3*lo+j].load(memory_order_relaxed);
+            res=(lo==b) ? 1 : 2;
+        }
+        else
+        {
+            //linear interpolation between the bin centers
+            tlo=tmin+(lo+0.5)*width;
+            w=(temp-tlo)/((hi-lo)*width);
+            if(w<0.0) w=0.0;
+            if(w>1.0) w=1.0;
+            for(int j=0;j<3;j++)
+            {
+                offset[j]=(1.0-w)*off[3*lo+j].load(memory_order_relaxed)+w*off[3*hi+j].load(memory_order_relaxed);
+            }
+            res=2;
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        v2=version.load(memory_order_relaxed);
+    } while((v1&1u) || v1!=v2);
+
+    if(res==0) for(int j=0;j<3;j++) offset[j]=0.0;
+    return res;
+}
+
+int tempcache::is_converged(int b)
+///******************************************************************
+/// IS_CONVERGED
+/// -----------------------------------------------------------------
+/// returns 1 if the bin b has converged and 0 otherwise
+/// -----------------------------------------------------------------
+/// b     - IN: bin index
+/// -----------------------------------------------------------------
+{
+    if(b<0 || b>=nbins) return 0;
+    return bins[b].converged;
+}
+
+int tempcache::save(const char *fname)
+///******************************************************************
+/// SAVE
+/// -----------------------------------------------------------------
+/// writes the table geometry and all converged bins into the text
+/// file fname. returns 1 on success and 0 otherwise
+/// -----------------------------------------------------------------
+/// fname - IN: name of the file
+/// -----------------------------------------------------------------
+{
+    FILE *fp=fopen(fname,"w");
+
+    if(fp==NULL)
+    {
+        printf("could not create file: %s\n",fname);
+        return 0;
+    }
+    fprintf(fp,"#tempcache %.17g %.17g %d\n",tmin,width,nbins);
+    for(int b=0;b<nbins;b++)
+    {
+        if(!bins[b].converged) continue;
+        fprintf(fp,"%d %.17g %.17g %.17g %d\n",b,bins[b].stat[0][2],bins[b].stat[1][2],bins[b].stat[2][2],bins[b].n);
+    }
+    fclose(fp);
+    return 1;
+}
+
+int tempcache::load(const char *fname)
+///******************************************************************
+/// LOAD
+/// -----------------------------------------------------------------
+/// reads a table written by save; the geometry of the file replaces
+/// the current one and its bins are marked converged such that they
+/// are not calibrated again. returns 1 on success and 0 otherwise
+/// -----------------------------------------------------------------
+/// fname - IN: name of the file
+/// -----------------------------------------------------------------
+{
+    FILE *fp=fopen(fname,"r");
+    double t0,w,o[3];
+    int nb,b,n;
+
+    if(fp==NULL) return 0;
+    if(fscanf(fp,"#tempcache %lf %lf %d",&t0,&w,&nb)!=3 || nb<=0 || w<=0.0)
+    {
+        printf("%s is not a temperature table\n",fname);
+        fclose(fp);
+        return 0;
+    }
+    setup(t0,w,nb);
+    while(fscanf(fp,"%d %lf %lf %lf %d",&b,&o[0],&o[1],&o[2],&n)==5)
+    {
+        if(b<0 || b>=nbins) continue;
+        for(int j=0;j<3;j++) bins[b].stat[j][2]=o[j];
+        bins[b].n=n;
+        bins[b].converged=1;
+        publish(b);
+    }
+    fclose(fp);
+    return 1;
+}
@@ -0,0 +1,152 @@
+//
+// Created by stefan on 09.03.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_TEMPCACHE_H
+#define PUBLICATION_RECURSIVE_MEAN_TEMPCACHE_H
+
+#include <vector>
+#include <atomic>
+#include <memory>
+using namespace std;
+
+//*******************************************************************
+// table of gyroscopic offsets keyed by temperature bins. Each bin has
+// its own recursion (recstat::seq_update) for the three components
+// which is fed incrementally and frozen once the bin has converged.
+// Between converged bins the offset is interpolated linearly between
+// the bin centers. For an O(1) lookup every bin stores the indices of
+// the nearest converged bins below and above, which are only updated
+// when a bin converges; the lookup tables are guarded by a sequence
+// counter so that lookup is lock-free and may be called from another
+// thread (e.g. the sensor hot path) while update is running.
+//*******************************************************************
+
+class tempcache {
+
+private:
+
+    typedef struct temp_bin
+    {
+        double stat[3][4];    //recursion of the three components
+        int n;                //number of samples in the bin
+        int converged;        //1 once the bin has converged (or was loaded)
+    } bin;
+
+    vector<bin> bins;
+    //lookup tables shared with readers, accessed through relaxed atomics
+    unique_ptr<atomic<double>[]> off; //[3*bin] offsets of the converged bins
+    unique_ptr<atomic<int>[]> below;  //nearest converged bin <= bin (-1 if none)
+    unique_ptr<atomic<int>[]> above;  //nearest converged bin >= bin (-1 if none)
+    atomic<unsigned> version;         //odd while the lookup tables are changed
+
+    void publish(int b);
+
+public:
+
+    double tmin=-40.0;        //lower edge of the first bin
+    double width=5.0;         //width of each bin
+    int nbins=0;
+    double prop_chosen=0.9;   //acceptance probability
+    double fractional_chosen=0.005; //fractional accuracy
+    int min_runs=100;         //minimum number of samples per bin
+
+    tempcache();
+
+    ///******************************************************************
+    /// SETUP
+    /// -----------------------------------------------------------------
+    /// creates nb empty bins of width w starting at temperature t0
+    /// -----------------------------------------------------------------
+    /// t0    - IN: lower edge of the first bin
+    /// w     - IN: width of the bins
+    /// nb    - IN: number of bins
+    /// -----------------------------------------------------------------
+
+    void setup(double t0, double w, int nb);
+
+    ///******************************************************************
+    /// BIN_INDEX
+    /// -----------------------------------------------------------------
+    /// returns the bin of the temperature temp (clamped to the table)
+    /// -----------------------------------------------------------------
+    /// temp  - IN: temperature
+    /// -----------------------------------------------------------------
+
+    int bin_index(double temp);
+
+    ///******************************************************************
+    /// UPDATE
+    /// -----------------------------------------------------------------
+    /// feeds the sample x[0..2] into the recursion of the bin of the
+    /// temperature temp unless that bin has already converged. returns
+    /// 1 if the bin converged with this sample and 0 otherwise
+    /// -----------------------------------------------------------------
+    /// temp  - IN: temperature of the sample
+    /// x     - IN: gyroscopic sample (three components)
+    /// -----------------------------------------------------------------
+
+    int update(double temp, const double x[]);
+
+    ///******************************************************************
+    /// LOOKUP
+    /// -----------------------------------------------------------------
+    /// returns the offsets for the temperature temp: the offsets of its
+    /// bin if it has converged, otherwise interpolated between (or taken
+    /// from) the nearest converged bins. returns 1 if the bin itself is
+    /// converged, 2 if interpolated resp. extrapolated and 0 if no bin
+    /// has converged yet. O(1), lock-free and without allocation
+    /// -----------------------------------------------------------------
+    /// temp  - IN : temperature
+    /// offset- OUT: offsets of the three components
+    /// -----------------------------------------------------------------
+
+    int lookup(double temp, double offset[]);
+
+    ///******************************************************************
+    /// IS_CONVERGED
+    /// -----------------------------------------------------------------
+    /// returns 1 if the bin b has converged and 0 otherwise
+    /// -----------------------------------------------------------------
+    /// b     - IN: bin index
+    /// -----------------------------------------------------------------
+
+    int is_converged(int b);
+
+    ///******************************************************************
+    /// SAVE
+    /// -----------------------------------------------------------------
+    /// writes the table geometry and all converged bins into the text
+    /// file fname. returns 1 on success and 0 otherwise
+    /// -----------------------------------------------------------------
+    /// fname - IN: name of the file
+    /// -----------------------------------------------------------------
+
+    int save(const char *fname);
+
+    ///******************************************************************
+    /// LOAD
+    /// -----------------------------------------------------------------
+    /// reads a table written by save; the geometry of the file replaces
+    /// the current one and its bins are marked converged such that they
+    /// are not calibrated again. returns 1 on success and 0 otherwise
+    /// -----------------------------------------------------------------
+    /// fname - IN: name of the file
+    /// -----------------------------------------------------------------
+
+    int load(const char *fname);
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_TEMPCACHE_H
@@ -0,0 +1,128 @@
+//
+// Created by stefan on 06.04.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "timeindex.h"
+#include <algorithm>
+#include <math.h>
+using namespace std;
+
+void timeindex::build(const double tt[], int nn)
+///******************************************************************
+/// BUILD
+/// -----------------------------------------------------------------
+/// sets up the index for the ascending time stamps tt[0..nn-1]
+/// (only a few intervals are read, no tables are built)
+/// -----------------------------------------------------------------
+/// tt    - IN: time stamps
+/// nn    - IN: number of time stamps
+/// -----------------------------------------------------------------
+{
+    double dt[TIMEINDEX_RATE_SAMPLES];
+    int m=0;
+
+    t=tt;
+    n=nn;
+    t0=(n>0) ? t[0] : 0.0;
+    rate_mean=(n>1 && t[n-1]>t[0]) ? (double) (n-1)/(t[n-1]-t[0]) : 0.0;
+    rate=rate_mean;
+    //nominal sampling interval: median of intervals spread over the table,
+    //unlike the mean it is not inflated by gaps
+    for(int k=0;k<TIMEINDEX_RATE_SAMPLES && n>1;k++)
+    {
+        int i=(int) ((long) k*(n-1)/TIMEINDEX_RATE_SAMPLES);
+        if(t[i+1]>t[i]) dt[m++]=t[i+1]-t[i];
+    }
+    if(m>0)
+    {
+        nth_element(dt,dt+m/2,dt+m);
+        rate=1.0/dt[m/2];
+    }
+}
+
+int timeindex::search(double x, int guess) const
+//exact search for t[j] <= x < t[j+1] with t[0] <= x < t[n-1], starting at guess
+{
+    int lo=0,hi=n-1,g=guess,jm;
+    double step;
+
+    //secant steps with the nominal rate inside the bracket t[lo] <= x < t[hi]:
+    //without gap between probe and x the next probe is off by the jitter only,
+    //every step crosses one gap
+    for(int k=0;k<TIMEINDEX_PROBES && hi-lo>1;k++)
+    {
+        if(g<=lo) g=lo+1;
+        if(g>=hi) g=hi-1;
+        if(t[g]<=x)
+        {
+            lo=g;
+            if(x<t[g+1]) return g;
+            lo=g+1;
+        }
+        else hi=g;
+        step=floor((x-t[g])*rate);
+        if(step<-n) step=-n;
+        if(step>n) step=n;
+        g+=(int) step;
+    }
+    //bisection of what is left
+    while(hi-lo>1)
+    {
+        jm=(lo+hi)>>1;
+        if(t[jm]<=x) lo=jm;
+        else hi=jm;
+    }
+    return lo;
+}
+
+int timeindex::locate(double x) const
+///******************************************************************
+/// LOCATE
+/// -----------------------------------------------------------------
+/// returns the index j of the interval with t[j] <= x < t[j+1]
+/// (j=n-2 for x=t[n-1], i.e. the result of mathb::locate) or
+/// TIMEINDEX_NOT_FOUND if x is outside of [t[0]:t[n-1]]
+/// -----------------------------------------------------------------
+/// x     - IN: time
+/// -----------------------------------------------------------------
+{
+    //comparisons only: also rejects nan
+    if(n<2 || !(x>=t[0] && x<=t[n-1])) return TIMEINDEX_NOT_FOUND;
+    if(x==t[n-1]) return n-2;
+    return search(x,(int) ((x-t0)*rate_mean));
+}
+
+int timeindex::locate_batch(const double x[], int m, int idx[]) const
+///******************************************************************
+/// LOCATE_BATCH
+/// -----------------------------------------------------------------
+/// locates the times x[0..m-1] (any order) into idx[0..m-1] and
+/// returns the number of times found
+/// -----------------------------------------------------------------
+/// x     - IN : times
+/// m     - IN : number of times
+/// idx   - OUT: interval indices or TIMEINDEX_NOT_FOUND
+/// -----------------------------------------------------------------
+{
+    int found=0;
+
+    //the guesses do not depend on each other: no state between the times
+    for(int k=0;k<m;k++)
+    {
+        if(n<2 || !(x[k]>=t[0] && x[k]<=t[n-1])) {idx[k]=TIMEINDEX_NOT_FOUND; continue;}
+        idx[k]=(x[k]==t[n-1]) ? n-2 : search(x[k],(int) ((x[k]-t0)*rate_mean));
+        found++;
+    }
+    return found;
+}
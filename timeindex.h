@@ -0,0 +1,92 @@
+//
+// Created by stefan on 06.04.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_TIMEINDEX_H
+#define PUBLICATION_RECURSIVE_MEAN_TIMEINDEX_H
+
+#define TIMEINDEX_NOT_FOUND (-1)      //result for times outside of the table
+#define TIMEINDEX_PROBES 8            //secant steps before the search falls back to bisection
+#define TIMEINDEX_RATE_SAMPLES 63     //intervals used for the nominal sampling rate
+
+//*******************************************************************
+// index into an ascending table of time stamps. The position of a
+// time is guessed by linear interpolation over the whole table and
+// refined by secant steps from the probed time stamps with the nominal
+// sampling interval (median of a few intervals, so gaps do not bias
+// it): for (nearly) uniform sampling the first or second probe hits,
+// each further step crosses one gap. The probes
+// narrow a bracket around the time which is bisected if the steps do
+// not converge, so the result is always exact. The table is not
+// copied and must outlive the index.
+//*******************************************************************
+
+class timeindex {
+
+private:
+
+    const double *t=nullptr;  //time stamps (not owned)
+    int n=0;
+    double t0=0.0;            //first time stamp
+    double rate_mean=0.0;     //inverse of the mean sampling interval (first guess)
+    double rate=0.0;          //inverse of the nominal sampling interval (secant steps)
+
+public:
+
+    ///******************************************************************
+    /// BUILD
+    /// -----------------------------------------------------------------
+    /// sets up the index for the ascending time stamps tt[0..nn-1]
+    /// (only a few intervals are read, no tables are built)
+    /// -----------------------------------------------------------------
+    /// tt    - IN: time stamps
+    /// nn    - IN: number of time stamps
+    /// -----------------------------------------------------------------
+
+    void build(const double tt[], int nn);
+
+    ///******************************************************************
+    /// LOCATE
+    /// -----------------------------------------------------------------
+    /// returns the index j of the interval with t[j] <= x < t[j+1]
+    /// (j=n-2 for x=t[n-1], i.e. the result of mathb::locate) or
+    /// TIMEINDEX_NOT_FOUND if x is outside of [t[0]:t[n-1]]
+    /// -----------------------------------------------------------------
+    /// x     - IN: time
+    /// -----------------------------------------------------------------
+
+    int locate(double x) const;
+
+    ///******************************************************************
+    /// LOCATE_BATCH
+    /// -----------------------------------------------------------------
+    /// locates the times x[0..m-1] (any order) into idx[0..m-1] and
+    /// returns the number of times found
+    /// -----------------------------------------------------------------
+    /// x     - IN : times
+    /// m     - IN : number of times
+    /// idx   - OUT: interval indices or TIMEINDEX_NOT_FOUND
+    /// -----------------------------------------------------------------
+
+    int locate_batch(const double x[], int m, int idx[]) const;
+
+    int size() const {return n;}
+
+private:
+
+    int search(double x, int guess) const;
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_TIMEINDEX_H
@@ -0,0 +1,86 @@
+//
+// Created by stefan on 20.02.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+//decoder for the binary trace files written by the class tracer: the
+//records are converted into CSV which is written to the given output
+//file or to stdout. A gap of records lost by a dropping tracer appears
+//as a row of the series "gap" with the number of lost records in the
+//column dropped (0 in all other rows) and the run counter of the record
+//following the gap.
+//usage: rec_gyro_tracecsv <trace file> [<csv file>]
+
+#include "tracer.h"
+#include <stdio.h>
+
+int main(int argc, char *argv[])
+{
+    FILE *in,*out=stdout;
+    trace_header hd;
+    trace_record r;
+    unsigned long n=0,lost=0;
+
+    if(argc<2)
+    {
+        printf("usage: %s <trace file> [<csv file>]\n",argv[0]);
+        return 1;
+    }
+    in=fopen(argv[1],"rb");
+    if(in==NULL)
+    {
+        printf("could not find file: %s\n",argv[1]);
+        return 1;
+    }
+    if(fread(&hd,sizeof(hd),1,in)!=1 || hd.magic!=TRACE_MAGIC || hd.version<1 || hd.version>TRACE_VERSION
+       || hd.record_size!=sizeof(trace_record))
+    {
+        printf("%s is not a trace file of this version\n",argv[1]);
+        fclose(in);
+        return 1;
+    }
+    if(argc>2)
+    {
+        out=fopen(argv[2],"w");
+        if(out==NULL)
+        {
+            printf("could not create file: %s\n",argv[2]);
+            fclose(in);
+            return 1;
+        }
+    }
+
+    fprintf(out,"series,axis,i,mean,variance,mean_of_mean,variance_of_mean,probability,dropped\n");
+    while(fread(&r,sizeof(r),1,in)==1)
+    {
+        if(r.series==TRACE_SERIES_GAP)
+        {
+            fprintf(out,"gap,,%u,,,,,,%.0f\n",r.i,r.stat[0]);
+            lost+=(unsigned long) r.stat[0];
+            continue;
+        }
+        fprintf(out,"%u,%u,%u,%.17g,%.17g,%.17g,%.17g,%.17g,0\n",(unsigned) r.series,(unsigned) r.axis,r.i,
+                r.stat[0],r.stat[1],r.stat[2],r.stat[3],r.prob);
+        n++;
+    }
+
+    fclose(in);
+    if(out!=stdout)
+    {
+        fclose(out);
+        printf("%lu records converted",n);
+        if(lost>0) printf(", %lu records lost in gaps",lost);
+        printf("\n");
+    }
+    return 0;
+}
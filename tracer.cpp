@@ -0,0 +1,156 @@
+//
+// Created by stefan on 20.02.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#include "tracer.h"
+#include <chrono>
+
+tracer::tracer() : head(0), tail(0), running(false)
+{
+}
+
+tracer::~tracer()
+{
+    close();
+}
+
+int tracer::open(const char *fname, size_t capacity)
+///******************************************************************
+/// OPEN
+/// -----------------------------------------------------------------
+/// creates the trace file, writes the header, allocates the ring
+/// buffer and starts the writer thread. returns 1 on success and 0
+/// if the file could not be created
+/// -----------------------------------------------------------------
+/// fname    - IN: name of the trace file
+/// capacity - IN: minimum number of records held by the ring buffer
+/// -----------------------------------------------------------------
+{
+    trace_header hd;
+    size_t size=1;
+
+    close();
+    fp=fopen(fname,"wb");
+    if(fp==NULL)
+    {
+        printf("could not create trace file: %s\n",fname);
+        return 0;
+    }
+    hd.magic=TRACE_MAGIC;
+    hd.version=TRACE_VERSION;
+    hd.record_size=sizeof(trace_record);
+    hd.reserved=0;
+    fwrite(&hd,sizeof(hd),1,fp);
+
+    while(size<capacity) size<<=1;
+    ring.assign(size,trace_record());
+    mask=size-1;
+    head.store(0);
+    tail.store(0);
+    lost=0;
+    dropped=0;
+    written=0;
+
+    running.store(true);
+    writer=thread(&tracer::flush_loop,this);
+    return 1;
+}
+
+size_t tracer::flush_pending()
+///******************************************************************
+/// FLUSH_PENDING
+/// -----------------------------------------------------------------
+/// writes all records between tail and head to the file, in at most
+/// two contiguous chunks, and releases their slots to the producer.
+/// returns the number of records written
+/// -----------------------------------------------------------------
+{
+    size_t t,h,n,first;
+
+    t=tail.load(memory_order_relaxed);
+    h=head.load(memory_order_acquire);
+    n=h-t;
+    if(n==0) return 0;
+
+    first=ring.size()-(t&mask);
+    if(first>n) first=n;
+    fwrite(&ring[t&mask],sizeof(trace_record),first,fp);
+    if(n>first) fwrite(&ring[0],sizeof(trace_record),n-first,fp);
+
+    tail.store(h,memory_order_release);
+    written+=n;
+    return n;
+}
+
+bool tracer::wait_for_slots(size_t h, size_t need)
+///******************************************************************
+/// WAIT_FOR_SLOTS
+/// -----------------------------------------------------------------
+/// called by record if the ring has less than need free slots: waits
+/// until the writer has released them and returns true, or, if block
+/// is not set, counts the record as lost and returns false
+/// -----------------------------------------------------------------
+{
+    if(!block)
+    {
+        lost++;
+        dropped++;
+        return false;
+    }
+    while(h+need-tail.load(memory_order_acquire)>mask+1) this_thread::yield();
+    return true;
+}
+
+void tracer::flush_loop()
+///******************************************************************
+/// FLUSH_LOOP
+/// -----------------------------------------------------------------
+/// body of the writer thread: flushes the ring buffer and sleeps
+/// shortly whenever it is found empty
+/// -----------------------------------------------------------------
+{
+    while(running.load(memory_order_acquire))
+    {
+        if(flush_pending()==0) this_thread::sleep_for(chrono::milliseconds(1));
+    }
+}
+
+void tracer::close()
+///******************************************************************
+/// CLOSE
+/// -----------------------------------------------------------------
+/// stops the writer thread, flushes all remaining records and closes
+/// the trace file. called by the destructor as well
+/// -----------------------------------------------------------------
+/// no input arguments
+/// -----------------------------------------------------------------
+{
+    if(fp==NULL) return;
+
+    running.store(false,memory_order_release);
+    if(writer.joinable()) writer.join();
+    flush_pending();
+    if(lost>0)
+    {
+        //records lost at the end of the trace
+        trace_record r;
+        double gap[4]={(double) lost,0.0,0.0,0.0};
+        fill(r,TRACE_SERIES_GAP,0,0,gap,0.0);
+        fwrite(&r,sizeof(r),1,fp);
+        lost=0;
+    }
+    fclose(fp);
+    fp=NULL;
+    if(dropped>0) printf("trace: %lu records dropped (ring buffer full)\n",dropped);
+}
@@ -0,0 +1,155 @@
+//
+// Created by stefan on 20.02.20.
+//
+// Copyright by Technical University Wildau, Research Group Telematics, fgtelematik[at]th-wildau.de
+// This Software is based on the Publication
+// "Optimization of MEMS-Gyroscope Calibration using Properties of Sums of Random Variables" by Kupper et al.
+//
+// the following License applies:
+//
+// this software may be freely distributed and changed provided that the following two conditions are met:
+// a) this copyright notice is retained.
+// b) the software is used for private and scientific or educational purposes only
+//
+// For commercial usage please contact fgtelematik[at]th-wildau.de for inquiries
+
+#ifndef PUBLICATION_RECURSIVE_MEAN_TRACER_H
+#define PUBLICATION_RECURSIVE_MEAN_TRACER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+#include <thread>
+using namespace std;
+
+#define TRACE_MAGIC 0x52544752u   //"RGTR"
+#define TRACE_VERSION 2u          //version 2 adds the gap records, version 1 files are read as well
+#define TRACE_SERIES_GAP 255      //series of a gap record
+
+//file header of a trace file
+typedef struct trace_file_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t reserved;
+} trace_header;
+
+//one fixed-size record per update of a single component; records lost
+//in a dropping tracer are replaced by one gap record (series
+//TRACE_SERIES_GAP, stat[0] the number of lost records, i the run
+//counter of the record following the gap or 0 at the end of the trace)
+typedef struct trace_file_record
+{
+    uint32_t i;           //run counter as in main.cpp
+    uint8_t series;       //0: synthetic data, 1: experimental data
+    uint8_t axis;         //component
+    uint16_t reserved;
+    double stat[4];       //mean, variance, mean of mean, variance of mean
+    double prob;          //acceptance probability
+} trace_record;
+
+//*******************************************************************
+// opt-in trace sink for the complete trajectory of the recursion. The
+// hot path (record) only copies the record into a preallocated single
+// producer/single consumer ring buffer; a background thread writes the
+// filled part of the ring to disk. If the ring is full the producer
+// waits for the writer (offline runs, the trace is complete), or, with
+// block=false for callers which must not wait (real-time loops), the
+// record is dropped and counted and the gap is marked in the trace by a
+// gap record.
+//*******************************************************************
+
+class tracer {
+
+private:
+
+    vector<trace_record> ring;       //preallocated ring buffer
+    size_t mask=0;                   //ring size-1 (ring size is a power of 2)
+    atomic<size_t> head;             //next slot to be written (producer)
+    atomic<size_t> tail;             //next slot to be flushed (consumer)
+    atomic<bool> running;
+    thread writer;
+    FILE *fp=NULL;
+    unsigned long lost=0;            //records lost since the last gap record
+
+    void flush_loop();
+    size_t flush_pending();
+    bool wait_for_slots(size_t h, size_t need);
+
+    static inline void fill(trace_record &r, int series, int axis, int i, const double stat[], double prob)
+    {
+        r.i=(uint32_t) i;
+        r.series=(uint8_t) series;
+        r.axis=(uint8_t) axis;
+        r.reserved=0;
+        for(int j=0;j<4;j++) r.stat[j]=stat[j];
+        r.prob=prob;
+    }
+
+public:
+
+    bool block=true;                 //wait for the writer if the ring is full (false: drop)
+    unsigned long dropped=0;         //number of records lost due to a full ring
+    unsigned long written=0;         //number of records written to disk
+
+    tracer();
+    ~tracer();
+
+    ///******************************************************************
+    /// OPEN
+    /// -----------------------------------------------------------------
+    /// creates the trace file, writes the header, allocates the ring
+    /// buffer and starts the writer thread. returns 1 on success and 0
+    /// if the file could not be created
+    /// -----------------------------------------------------------------
+    /// fname    - IN: name of the trace file
+    /// capacity - IN: minimum number of records held by the ring buffer
+    /// -----------------------------------------------------------------
+
+    int open(const char *fname, size_t capacity);
+
+    ///******************************************************************
+    /// RECORD
+    /// -----------------------------------------------------------------
+    /// stores the state of one component after an update in the ring
+    /// buffer. lock-free, to be called from the thread running the
+    /// recursion only; wait-free unless block is set and the ring is full
+    /// -----------------------------------------------------------------
+    /// series - IN: 0 for synthetic, 1 for experimental data
+    /// axis   - IN: component
+    /// i      - IN: run counter
+    /// stat   - IN: stat-array of recstat::seq_update
+    /// prob   - IN: acceptance probability
+    /// -----------------------------------------------------------------
+
+    inline void record(int series, int axis, int i, const double stat[], double prob)
+    {
+        size_t h=head.load(memory_order_relaxed),need=(lost>0) ? 2 : 1;
+        if(h+need-tail.load(memory_order_acquire)>mask+1 && !wait_for_slots(h,need)) return;
+        if(lost>0)
+        {
+            double gap[4]={(double) lost,0.0,0.0,0.0};
+            fill(ring[h&mask],TRACE_SERIES_GAP,0,i,gap,0.0);
+            h++;
+            lost=0;
+        }
+        fill(ring[h&mask],series,axis,i,stat,prob);
+        head.store(h+1,memory_order_release);
+    }
+
+    ///******************************************************************
+    /// CLOSE
+    /// -----------------------------------------------------------------
+    /// stops the writer thread, flushes all remaining records and closes
+    /// the trace file. called by the destructor as well
+    /// -----------------------------------------------------------------
+    /// no input arguments
+    /// -----------------------------------------------------------------
+
+    void close();
+
+};
+
+#endif //PUBLICATION_RECURSIVE_MEAN_TRACER_H